@@ -0,0 +1,80 @@
+// BenchmarkUtils.h
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+ #include <immintrin.h>
+#endif
+
+namespace bench
+{
+    using Clock = std::chrono::steady_clock;
+
+    inline double secondsSince(Clock::time_point t0)
+    {
+        return std::chrono::duration<double>(Clock::now() - t0).count();
+    }
+
+    // Runs fn() in batches until at least minSeconds have elapsed and
+    // returns the mean nanoseconds per call.
+    template <typename Fn>
+    double nsPerCall(Fn&& fn, double minSeconds = 0.2)
+    {
+        for (int i = 0; i < 16; ++i)
+            fn();
+
+        std::int64_t calls = 0;
+        int batch = 64;
+        auto t0 = Clock::now();
+        double elapsed = 0.0;
+        while (elapsed < minSeconds)
+        {
+            for (int i = 0; i < batch; ++i)
+                fn();
+            calls += batch;
+            batch *= 2;
+            elapsed = secondsSince(t0);
+        }
+        return elapsed * 1.0e9 / double(calls);
+    }
+
+    inline std::vector<float> noise(int n, float amplitude, unsigned seed = 1)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> dist(-amplitude, amplitude);
+        std::vector<float> v(static_cast<size_t>(n));
+        for (auto& x : v)
+            x = dist(rng);
+        return v;
+    }
+
+    // Flush denormals to zero, as hosts do on the audio thread. Envelopes that
+    // decay for millions of iterations would otherwise time the slow path.
+    inline void flushDenormals()
+    {
+       #if defined(__x86_64__) || defined(_M_X64)
+        _mm_setcsr(_mm_getcsr() | 0x8040); // FTZ | DAZ
+       #elif defined(__aarch64__)
+        std::uint64_t fpcr;
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+        __asm__ __volatile__("msr fpcr, %0" :: "r"(fpcr | (std::uint64_t(1) << 24)));
+       #endif
+    }
+
+    // Keeps the optimiser from discarding results: the empty asm claims to
+    // read v through memory, so whatever produced it has to be computed.
+    inline void doNotOptimise(float v)
+    {
+       #if defined(__GNUC__) || defined(__clang__)
+        __asm__ __volatile__("" : : "g"(&v) : "memory");
+       #else
+        static volatile float sink;
+        sink = v;
+        (void) sink;
+       #endif
+    }
+}
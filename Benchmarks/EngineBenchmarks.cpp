@@ -0,0 +1,335 @@
+// EngineBenchmarks.cpp
+// Regression suite for the hot path: processBlock() of both engines across
+// channel counts, host block sizes, sample rates and feature toggles, written
+// as CSV or JSON so runs from two releases can be diffed by a script.
+//
+//   mdp_engine_bench [--format csv|json] [--out file] [--full] [--min-time s]
+//
+// Every block is timed on its own, so besides the mean (as ns per sample per
+// channel) each row has per-block latency percentiles. The tail is what drops
+// out under a host: a block that overruns its period glitches however good the
+// mean is. load is the mean block time over the block period; the load_*
+// columns and overruns are what the plugin's DspLoadMeter reports for the run.
+//
+// By default each axis is swept around a baseline (16 channels, 256 samples,
+// 48 kHz, no features) and the features are crossed with the channel counts;
+// --full runs the whole cartesian product instead (slow). Features an engine
+// doesn't have (ML gating in the classic engine) are skipped.
+#include "BenchmarkUtils.h"
+#include "DspLoadMeter.h"
+#include "DspVoiceActivityDetector.h"
+#include "EnhancedDuganAGC.h"
+#include "MyDuganAutomixer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const int kChannelCounts[] = { 4, 8, 16, 32, 64, 128, 256 };
+    const int kBlockSizes[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    const double kSampleRates[] = { 44100.0, 48000.0, 96000.0 };
+
+    const int kBaselineChannels = 16;
+    const int kBaselineBlock = 256;
+    const double kBaselineRate = 48000.0;
+
+    const int kWarmupBlocks = 32;
+    const int kMinBlocks = 200;
+    const int kMaxBlocks = 200000;
+    const float kLookaheadMs = 5.f;
+
+    enum Feature
+    {
+        kLookahead = 1 << 0,
+        kMLGating  = 1 << 1,
+        kLeveler   = 1 << 2,
+        kAdaptive  = 1 << 3,
+        kAllFeatures = kLookahead | kMLGating | kLeveler | kAdaptive
+    };
+
+    const int kFeatureSets[] = { 0, kLookahead, kMLGating, kLeveler, kAdaptive, kAllFeatures };
+
+    struct Config
+    {
+        bool enhanced;
+        int channels;
+        int blockSize;
+        double sampleRate;
+        int features;
+    };
+
+    struct Result
+    {
+        Config config;
+        int blocks;
+        double nsPerSampleChannel;
+        double meanUs, p50Us, p90Us, p99Us, p999Us, maxUs;
+        double load;
+        DspLoadMeter::Stats meter;
+    };
+
+    // Talkers take turns every 100 ms over a room-noise floor, so gates open and
+    // close and the gain share moves as it does in a meeting. Loops after one second.
+    struct Program
+    {
+        Program(int numChannels, double sampleRate, int blockSize)
+            : length(static_cast<int>(sampleRate)),
+              source(static_cast<size_t>(numChannels)), work(static_cast<size_t>(numChannels)),
+              pointers(static_cast<size_t>(numChannels))
+        {
+            const int turn = static_cast<int>(sampleRate * 0.1);
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto floor = bench::noise(length, 0.003f, unsigned(ch + 1));
+                auto voice = bench::noise(length, 0.3f, unsigned(ch + 1000));
+                auto& s = source[size_t(ch)];
+                s.resize(size_t(length + blockSize));
+                for (int i = 0; i < length + blockSize; ++i)
+                {
+                    const int j = i % length;
+                    const bool talking = (j / turn + ch) % 5 == 0;
+                    s[size_t(i)] = floor[size_t(j)] + (talking ? voice[size_t(j)] : 0.f);
+                }
+                work[size_t(ch)].resize(size_t(blockSize));
+                pointers[size_t(ch)] = work[size_t(ch)].data();
+            }
+        }
+
+        // Engines scale in place; every block starts from fresh input at the next position.
+        float** next(int blockSize)
+        {
+            for (size_t ch = 0; ch < source.size(); ++ch)
+                std::memcpy(work[ch].data(), source[ch].data() + position, sizeof(float) * size_t(blockSize));
+            position = (position + blockSize) % length;
+            return pointers.data();
+        }
+
+        int length;
+        int position = 0;
+        std::vector<std::vector<float>> source, work;
+        std::vector<float*> pointers;
+    };
+
+    double percentile(const std::vector<double>& sorted, double p)
+    {
+        const size_t i = static_cast<size_t>(std::ceil(p * double(sorted.size()))) - 1;
+        return sorted[std::min(i, sorted.size() - 1)];
+    }
+
+    template <typename Engine>
+    Result run(const Config& c, double minSeconds)
+    {
+        Engine engine;
+        engine.setWorkerThreads(0);
+        engine.setLookaheadMs((c.features & kLookahead) ? kLookaheadMs : 0.f);
+        engine.setLinkLeveler((c.features & kLeveler) != 0);
+        engine.setUseAdaptiveThreshold((c.features & kAdaptive) != 0);
+        engine.setSidechainInfluence((c.features & kAdaptive) ? 6.f : 0.f);
+        engine.setUseMLSpeechDetection((c.features & kMLGating) != 0);
+        if (c.features & kMLGating)
+            engine.setSpeechDetector(std::make_shared<DspVoiceActivityDetector>(c.sampleRate, c.channels));
+
+        const int sideChannels = (c.features & kAdaptive) ? 1 : 0;
+        engine.prepare(c.sampleRate, c.blockSize, c.channels, sideChannels);
+
+        Program main(c.channels, c.sampleRate, c.blockSize);
+        Program side(1, c.sampleRate, c.blockSize);
+
+        DspLoadMeter meter;
+        meter.prepare(c.sampleRate);
+
+        auto block = [&]
+        {
+            float** data = main.next(c.blockSize);
+            float** sideData = sideChannels > 0 ? side.next(c.blockSize) : nullptr;
+            DspLoadMeter::ScopedBlock timing(meter, c.blockSize);
+            const auto t0 = bench::Clock::now();
+            engine.processBlock(data, c.channels, c.blockSize, sideData, sideChannels, c.blockSize);
+            return std::chrono::duration<double, std::nano>(bench::Clock::now() - t0).count();
+        };
+
+        for (int i = 0; i < kWarmupBlocks; ++i)
+            block();
+        meter.reset();
+
+        std::vector<double> ns;
+        ns.reserve(kMaxBlocks);
+        double total = 0.0;
+        while ((int(ns.size()) < kMinBlocks || total < minSeconds * 1.0e9) && int(ns.size()) < kMaxBlocks)
+        {
+            ns.push_back(block());
+            total += ns.back();
+        }
+
+        float checksum = 0.f;
+        for (int ch = 0; ch < c.channels; ++ch)
+            checksum += engine.getChannelAutoGainDb(ch);
+        bench::doNotOptimise(checksum);
+
+        std::sort(ns.begin(), ns.end());
+        const double mean = total / double(ns.size());
+        const double periodNs = 1.0e9 * c.blockSize / c.sampleRate;
+
+        Result r;
+        r.config = c;
+        r.blocks = int(ns.size());
+        r.nsPerSampleChannel = mean / (double(c.blockSize) * c.channels);
+        r.meanUs = mean / 1000.0;
+        r.p50Us = percentile(ns, 0.5) / 1000.0;
+        r.p90Us = percentile(ns, 0.9) / 1000.0;
+        r.p99Us = percentile(ns, 0.99) / 1000.0;
+        r.p999Us = percentile(ns, 0.999) / 1000.0;
+        r.maxUs = ns.back() / 1000.0;
+        r.load = mean / periodNs;
+        r.meter = meter.getStats();
+        return r;
+    }
+
+    std::vector<Config> sweep(bool full)
+    {
+        std::vector<Config> configs;
+        auto add = [&](int channels, int blockSize, double rate, int features)
+        {
+            for (bool enhanced : { true, false })
+            {
+                if (!enhanced && (features & kMLGating))
+                    continue;
+                const Config c { enhanced, channels, blockSize, rate, features };
+                const bool seen = std::any_of(configs.begin(), configs.end(), [&](const Config& o) {
+                    return o.enhanced == c.enhanced && o.channels == c.channels && o.blockSize == c.blockSize
+                        && o.sampleRate == c.sampleRate && o.features == c.features;
+                });
+                if (!seen)
+                    configs.push_back(c);
+            }
+        };
+
+        if (full)
+        {
+            for (int features : kFeatureSets)
+                for (double rate : kSampleRates)
+                    for (int blockSize : kBlockSizes)
+                        for (int channels : kChannelCounts)
+                            add(channels, blockSize, rate, features);
+            return configs;
+        }
+
+        for (int features : kFeatureSets)
+            for (int channels : kChannelCounts)
+                add(channels, kBaselineBlock, kBaselineRate, features);
+        for (int blockSize : kBlockSizes)
+            for (int channels : { kBaselineChannels, 128 })
+                add(channels, blockSize, kBaselineRate, 0);
+        for (double rate : kSampleRates)
+            for (int channels : { kBaselineChannels, 128 })
+                add(channels, kBaselineBlock, rate, 0);
+        return configs;
+    }
+
+    const char* const kFlagNames[] = { "lookahead", "ml_gating", "leveler", "adaptive_threshold" };
+
+    void writeCsv(std::FILE* out, const std::vector<Result>& results)
+    {
+        std::fprintf(out, "engine,channels,block_size,sample_rate");
+        for (const char* name : kFlagNames)
+            std::fprintf(out, ",%s", name);
+        std::fprintf(out, ",blocks,ns_per_sample_channel,mean_us,p50_us,p90_us,p99_us,p999_us,max_us,load,load_p50,load_p99,load_max,overruns\n");
+
+        for (const auto& r : results)
+        {
+            const Config& c = r.config;
+            std::fprintf(out, "%s,%d,%d,%.0f", c.enhanced ? "enhanced" : "classic", c.channels, c.blockSize, c.sampleRate);
+            for (int bit = 0; bit < 4; ++bit)
+                std::fprintf(out, ",%d", (c.features >> bit) & 1);
+            std::fprintf(out, ",%d,%.4f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.5f,%.4f,%.4f,%.4f,%llu\n", r.blocks,
+                         r.nsPerSampleChannel, r.meanUs, r.p50Us, r.p90Us, r.p99Us, r.p999Us, r.maxUs, r.load,
+                         r.meter.p50, r.meter.p99, r.meter.max, (unsigned long long) r.meter.overruns);
+        }
+    }
+
+    void writeJson(std::FILE* out, const std::vector<Result>& results)
+    {
+        std::fprintf(out, "{\n  \"kernels\": \"%s\",\n  \"cores\": %u,\n  \"results\": [\n",
+                     VectorKernels::select().name, std::thread::hardware_concurrency());
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+            const Config& c = r.config;
+            std::fprintf(out, "    { \"engine\": \"%s\", \"channels\": %d, \"block_size\": %d, \"sample_rate\": %.0f",
+                         c.enhanced ? "enhanced" : "classic", c.channels, c.blockSize, c.sampleRate);
+            for (int bit = 0; bit < 4; ++bit)
+                std::fprintf(out, ", \"%s\": %s", kFlagNames[bit], ((c.features >> bit) & 1) ? "true" : "false");
+            std::fprintf(out, ", \"blocks\": %d, \"ns_per_sample_channel\": %.4f, \"mean_us\": %.3f, "
+                              "\"p50_us\": %.3f, \"p90_us\": %.3f, \"p99_us\": %.3f, \"p999_us\": %.3f, "
+                              "\"max_us\": %.3f, \"load\": %.5f, \"load_p50\": %.4f, \"load_p99\": %.4f, "
+                              "\"load_max\": %.4f, \"overruns\": %llu }%s\n",
+                         r.blocks, r.nsPerSampleChannel, r.meanUs, r.p50Us, r.p90Us, r.p99Us, r.p999Us,
+                         r.maxUs, r.load, r.meter.p50, r.meter.p99, r.meter.max,
+                         (unsigned long long) r.meter.overruns, i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(out, "  ]\n}\n");
+    }
+
+    int usage()
+    {
+        std::fprintf(stderr, "usage: mdp_engine_bench [--format csv|json] [--out file] [--full] [--min-time s]\n");
+        return 2;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool json = false, full = false;
+    const char* outPath = nullptr;
+    double minSeconds = 0.05;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--format" && hasValue)
+        {
+            const std::string format = argv[++i];
+            if (format != "csv" && format != "json")
+                return usage();
+            json = format == "json";
+        }
+        else if (arg == "--out" && hasValue)       outPath = argv[++i];
+        else if (arg == "--min-time" && hasValue)  minSeconds = std::atof(argv[++i]);
+        else if (arg == "--full")                  full = true;
+        else                                       return usage();
+    }
+
+    bench::flushDenormals();
+
+    const auto configs = sweep(full);
+    std::vector<Result> results;
+    results.reserve(configs.size());
+    for (size_t i = 0; i < configs.size(); ++i)
+    {
+        const Config& c = configs[i];
+        results.push_back(c.enhanced ? run<EnhancedDuganAGC>(c, minSeconds) : run<MyDuganAutomixer>(c, minSeconds));
+        std::fprintf(stderr, "\r%zu/%zu", i + 1, configs.size());
+    }
+    std::fprintf(stderr, "\n");
+
+    std::FILE* out = outPath != nullptr ? std::fopen(outPath, "w") : stdout;
+    if (out == nullptr)
+    {
+        std::fprintf(stderr, "mdp_engine_bench: cannot write %s\n", outPath);
+        return 1;
+    }
+    if (json)
+        writeJson(out, results);
+    else
+        writeCsv(out, results);
+    if (out != stdout)
+        std::fclose(out);
+    return 0;
+}
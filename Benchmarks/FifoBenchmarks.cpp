@@ -0,0 +1,196 @@
+// FifoBenchmarks.cpp
+// Producer -> consumer throughput of LockFreeFifo on two threads: single
+// push()/pop(), pushN()/popN() runs, in-place two-segment access with
+// audio-sized float blocks, and a move-only element type. Every run checks
+// that the consumer saw the producer's sequence in order. A side that finds
+// the fifo full/empty yields, so this also runs sensibly on a single core.
+#include "BenchmarkUtils.h"
+#include "LockFreeFifo.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t kCapacity = 4096;
+
+    struct Result
+    {
+        double itemsPerSecond = 0.0;
+        bool inOrder = true;
+    };
+
+    // Runs produce(fifo, n) and consume(fifo, n) on two threads. The consumer
+    // returns false if it saw an item out of order.
+    template <typename T, typename Producer, typename Consumer>
+    Result runPair(std::uint64_t numItems, Producer&& produce, Consumer&& consume)
+    {
+        LockFreeFifo<T> fifo(kCapacity);
+        bool inOrder = true;
+
+        auto t0 = bench::Clock::now();
+        std::thread consumer([&] { inOrder = consume(fifo, numItems); });
+        produce(fifo, numItems);
+        consumer.join();
+        double seconds = bench::secondsSince(t0);
+
+        return { double(numItems) / seconds, inOrder };
+    }
+
+    Result singleItems(std::uint64_t n)
+    {
+        return runPair<std::uint64_t>(n,
+            [](LockFreeFifo<std::uint64_t>& f, std::uint64_t count)
+            {
+                for (std::uint64_t i = 0; i < count;)
+                    if (f.push(i))
+                        ++i;
+                    else
+                        std::this_thread::yield();
+            },
+            [](LockFreeFifo<std::uint64_t>& f, std::uint64_t count)
+            {
+                bool ok = true;
+                for (std::uint64_t i = 0, v = 0; i < count;)
+                    if (f.pop(v))
+                        ok &= (v == i++);
+                    else
+                        std::this_thread::yield();
+                return ok;
+            });
+    }
+
+    Result bulkItems(std::uint64_t n, std::size_t run)
+    {
+        return runPair<std::uint64_t>(n,
+            [run](LockFreeFifo<std::uint64_t>& f, std::uint64_t count)
+            {
+                std::vector<std::uint64_t> items(run);
+                for (std::uint64_t i = 0; i < count;)
+                {
+                    const auto want = std::size_t(std::min<std::uint64_t>(run, count - i));
+                    for (std::size_t k = 0; k < want; ++k)
+                        items[k] = i + k;
+                    // Whatever didn't fit goes again with the next run.
+                    const auto pushed = f.pushN(items.data(), want);
+                    if (pushed == 0)
+                        std::this_thread::yield();
+                    i += pushed;
+                }
+            },
+            [run](LockFreeFifo<std::uint64_t>& f, std::uint64_t count)
+            {
+                std::vector<std::uint64_t> items(run);
+                bool ok = true;
+                for (std::uint64_t i = 0; i < count;)
+                {
+                    const auto got = f.popN(items.data(), run);
+                    if (got == 0)
+                        std::this_thread::yield();
+                    for (std::size_t k = 0; k < got; ++k)
+                        ok &= (items[k] == i++);
+                }
+                return ok;
+            });
+    }
+
+    // Samples written and read in place, blockSize at a time, as an audio callback would.
+    Result audioBlocks(std::uint64_t n, std::size_t blockSize)
+    {
+        return runPair<float>(n,
+            [blockSize](LockFreeFifo<float>& f, std::uint64_t count)
+            {
+                for (std::uint64_t i = 0; i < count;)
+                {
+                    auto s = f.prepareToWrite(std::size_t(std::min<std::uint64_t>(blockSize, count - i)));
+                    for (std::size_t k = 0; k < s.firstSize; ++k)
+                        s.first[k] = float((i + k) & 0xffff);
+                    for (std::size_t k = 0; k < s.secondSize; ++k)
+                        s.second[k] = float((i + s.firstSize + k) & 0xffff);
+                    f.finishedWrite(s.size());
+                    if (s.size() == 0)
+                        std::this_thread::yield();
+                    i += s.size();
+                }
+            },
+            [blockSize](LockFreeFifo<float>& f, std::uint64_t count)
+            {
+                bool ok = true;
+                for (std::uint64_t i = 0; i < count;)
+                {
+                    auto s = f.prepareToRead(blockSize);
+                    for (std::size_t k = 0; k < s.firstSize; ++k)
+                        ok &= (s.first[k] == float((i + k) & 0xffff));
+                    for (std::size_t k = 0; k < s.secondSize; ++k)
+                        ok &= (s.second[k] == float((i + s.firstSize + k) & 0xffff));
+                    f.finishedRead(s.size());
+                    if (s.size() == 0)
+                        std::this_thread::yield();
+                    i += s.size();
+                }
+                return ok;
+            });
+    }
+
+    // Ownership moves through the ring; nothing is copied. The items are
+    // allocated up front so the timing is the fifo's, not the allocator's.
+    Result moveOnly(std::uint64_t n)
+    {
+        std::vector<std::unique_ptr<std::uint64_t>> items(n);
+        for (std::uint64_t i = 0; i < n; ++i)
+            items[i] = std::make_unique<std::uint64_t>(i);
+
+        return runPair<std::unique_ptr<std::uint64_t>>(n,
+            [&items](LockFreeFifo<std::unique_ptr<std::uint64_t>>& f, std::uint64_t count)
+            {
+                for (std::uint64_t i = 0; i < count;)
+                    if (f.push(std::move(items[i])))
+                        ++i;
+                    else
+                        std::this_thread::yield();
+            },
+            [](LockFreeFifo<std::unique_ptr<std::uint64_t>>& f, std::uint64_t count)
+            {
+                bool ok = true;
+                std::unique_ptr<std::uint64_t> item;
+                for (std::uint64_t i = 0; i < count;)
+                    if (f.pop(item))
+                        ok &= (item != nullptr && *item == i++);
+                    else
+                        std::this_thread::yield();
+                return ok;
+            });
+    }
+
+    void print(const char* name, const Result& r)
+    {
+        std::printf("%-28s %10.1f M items/s%s\n", name, r.itemsPerSecond / 1.0e6, r.inOrder ? "" : "   OUT OF ORDER");
+    }
+}
+
+int main()
+{
+    const std::uint64_t n = 20'000'000;
+    std::printf("LockFreeFifo, capacity %zu, %llu items, producer and consumer on two threads\n\n",
+                kCapacity, static_cast<unsigned long long>(n));
+
+    print("push/pop", singleItems(n));
+    for (std::size_t run : { 16, 64, 256 })
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "pushN/popN, runs of %zu", run);
+        print(name, bulkItems(n, run));
+    }
+    for (std::size_t block : { 64, 512 })
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "in place, %zu-sample blocks", block);
+        print(name, audioBlocks(n, block));
+    }
+    print("push/pop, move-only", moveOnly(n / 4));
+    return 0;
+}
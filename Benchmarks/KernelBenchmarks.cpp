@@ -0,0 +1,135 @@
+// KernelBenchmarks.cpp
+// Per-kernel timings for every VectorKernels level this CPU supports,
+// with speedup relative to the scalar reference, plus the FastMath
+// dB/linear conversions against std::pow/std::log10.
+#include "BenchmarkUtils.h"
+#include "FastMath.h"
+#include "VectorKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+    struct KernelTimes
+    {
+        double sumSquares, scaleInPlace, scaleAndAccumulate, peak, scaleInPlaceRamp, scaleAndAccumulateRamp;
+    };
+
+    KernelTimes timeKernels(const VectorKernels& k, int n)
+    {
+        auto src = bench::noise(n, 0.5f, 1);
+        auto dst = bench::noise(n, 0.5f, 2);
+
+        KernelTimes t {};
+        t.sumSquares = bench::nsPerCall([&] { bench::doNotOptimise(k.sumSquares(src.data(), n)); });
+        // Alternate gains so repeated scaling neither blows up nor flushes to zero.
+        float g = 1.0001f;
+        t.scaleInPlace = bench::nsPerCall([&] { k.scaleInPlace(dst.data(), n, g); g = 1.f / g; });
+        t.scaleAndAccumulate = bench::nsPerCall([&] { k.scaleAndAccumulate(dst.data(), src.data(), n, g); g = -g; });
+        t.peak = bench::nsPerCall([&] { bench::doNotOptimise(k.peak(src.data(), n)); });
+        // Ramps of 1 -> 1 +/- 1e-4 alternate so the data stays out of denormal range.
+        float delta = 1.0e-4f;
+        t.scaleInPlaceRamp = bench::nsPerCall([&] { k.scaleInPlaceRamp(dst.data(), n, 1.f, 1.f + delta); delta = -delta; });
+        t.scaleAndAccumulateRamp = bench::nsPerCall([&] { k.scaleAndAccumulateRamp(dst.data(), src.data(), n, g, 2.f * g); g = -g; });
+        return t;
+    }
+
+    // Largest relative difference to the scalar reference over a few odd lengths.
+    float maxRelativeError(const VectorKernels& k)
+    {
+        const auto& ref = VectorKernels::scalarKernels();
+        float worst = 0.f;
+        for (int n : { 0, 1, 7, 15, 31, 63, 257, 4099 })
+        {
+            auto x = bench::noise(std::max(n, 1), 1.f, unsigned(n + 3));
+            float a = ref.sumSquares(x.data(), n), b = k.sumSquares(x.data(), n);
+            worst = std::max(worst, std::abs(a - b) / std::max(1.0e-12f, std::abs(a)));
+            if (ref.peak(x.data(), n) != k.peak(x.data(), n))
+                worst = std::max(worst, 1.f);
+
+            auto d0 = bench::noise(std::max(n, 1), 1.f, 11), d1 = d0;
+            ref.scaleAndAccumulate(d0.data(), x.data(), n, 0.3f);
+            k.scaleAndAccumulate(d1.data(), x.data(), n, 0.3f);
+            ref.scaleInPlace(d0.data(), n, 0.7f);
+            k.scaleInPlace(d1.data(), n, 0.7f);
+            ref.scaleInPlaceRamp(d0.data(), n, 0.2f, 1.3f);
+            k.scaleInPlaceRamp(d1.data(), n, 0.2f, 1.3f);
+            ref.scaleAndAccumulateRamp(d0.data(), x.data(), n, 0.4f, 0.9f);
+            k.scaleAndAccumulateRamp(d1.data(), x.data(), n, 0.4f, 0.9f);
+            for (int i = 0; i < n; ++i)
+                worst = std::max(worst, std::abs(d0[size_t(i)] - d1[size_t(i)]) / std::max(1.0e-6f, std::abs(d0[size_t(i)])));
+        }
+        return worst;
+    }
+
+    void benchFastMath()
+    {
+        const int n = 1024;
+        std::vector<float> db(n), lin(n), out(n);
+        for (int i = 0; i < n; ++i)
+        {
+            db[size_t(i)] = -120.f + 160.f * float(i) / float(n);
+            lin[size_t(i)] = std::pow(10.f, db[size_t(i)] / 20.f);
+        }
+
+        double stdToLin = bench::nsPerCall([&] { for (int i = 0; i < n; ++i) out[size_t(i)] = std::pow(10.f, db[size_t(i)] / 20.f); bench::doNotOptimise(out[7]); });
+        double fastToLin = bench::nsPerCall([&] { for (int i = 0; i < n; ++i) out[size_t(i)] = FastMath::dbToLinear(db[size_t(i)]); bench::doNotOptimise(out[7]); });
+        double stdToDb = bench::nsPerCall([&] { for (int i = 0; i < n; ++i) out[size_t(i)] = 20.f * std::log10(lin[size_t(i)]); bench::doNotOptimise(out[7]); });
+        double fastToDb = bench::nsPerCall([&] { for (int i = 0; i < n; ++i) out[size_t(i)] = FastMath::linearToDb(lin[size_t(i)]); bench::doNotOptimise(out[7]); });
+
+        double relErr = 0.0, absErrDb = 0.0;
+        for (double d = -150.0; d <= 60.0; d += 0.0137)
+        {
+            double ref = std::pow(10.0, d / 20.0);
+            relErr = std::max(relErr, std::abs(FastMath::dbToLinear(float(d)) - ref) / ref);
+        }
+        for (double l = 1.0e-9; l <= 1.0e3; l *= 1.0011)
+            absErrDb = std::max(absErrDb, std::abs(double(FastMath::linearToDb(float(l))) - 20.0 * std::log10(double(float(l)))));
+
+        std::printf("\nFastMath (ns per value, n=%d):\n", n);
+        std::printf("  dbToLinear  std %.2f  fast %.2f  (%.1fx)  max rel error %.2e over [-150, 60] dB\n",
+                    stdToLin / n, fastToLin / n, stdToLin / fastToLin, relErr);
+        std::printf("  linearToDb  std %.2f  fast %.2f  (%.1fx)  max abs error %.2e dB over [1e-9, 1e3]\n",
+                    stdToDb / n, fastToDb / n, stdToDb / fastToDb, absErrDb);
+    }
+}
+
+int main()
+{
+    std::printf("selected: %s\n\n", VectorKernels::select().name);
+    std::printf("%-8s %6s %14s %14s %14s %14s %14s %14s   (ns/call, speedup vs scalar)\n",
+                "level", "n", "sumSquares", "scaleInPlace", "scaleAndAcc", "peak", "gainRamp", "accRamp");
+
+    const VectorKernels::Level levels[] = { VectorKernels::Level::scalar, VectorKernels::Level::neon,
+                                            VectorKernels::Level::avx2, VectorKernels::Level::avx512 };
+
+    for (int n : { 64, 256, 1024, 4096 })
+    {
+        KernelTimes scalar = timeKernels(VectorKernels::scalarKernels(), n);
+        for (auto l : levels)
+        {
+            const VectorKernels* k = VectorKernels::forLevel(l);
+            if (k == nullptr)
+                continue;
+            KernelTimes t = l == VectorKernels::Level::scalar ? scalar : timeKernels(*k, n);
+            std::printf("%-8s %6d %8.1f %4.1fx %8.1f %4.1fx %8.1f %4.1fx %8.1f %4.1fx %8.1f %4.1fx %8.1f %4.1fx\n",
+                        k->name, n,
+                        t.sumSquares, scalar.sumSquares / t.sumSquares,
+                        t.scaleInPlace, scalar.scaleInPlace / t.scaleInPlace,
+                        t.scaleAndAccumulate, scalar.scaleAndAccumulate / t.scaleAndAccumulate,
+                        t.peak, scalar.peak / t.peak,
+                        t.scaleInPlaceRamp, scalar.scaleInPlaceRamp / t.scaleInPlaceRamp,
+                        t.scaleAndAccumulateRamp, scalar.scaleAndAccumulateRamp / t.scaleAndAccumulateRamp);
+        }
+    }
+
+    std::printf("\nmax relative error vs scalar:\n");
+    for (auto l : levels)
+        if (const VectorKernels* k = VectorKernels::forLevel(l))
+            std::printf("  %-8s %.2e\n", k->name, double(maxRelativeError(*k)));
+
+    benchFastMath();
+    return 0;
+}
@@ -0,0 +1,123 @@
+// SpeechLatencyBenchmarks.cpp
+// Decision latency of the asynchronous ML/VAD path. The audio thread is played
+// in real time (one block per block period) and feeds SpeechAnalysisThread. A
+// synthetic detector burns a fixed time per channel per frame. Latency is the
+// time from the end of an analysed frame to the start of the block that
+// collects its result. That is the delay before speech gating can react. The
+// table also shows what pushAudio() costs the audio thread.
+#include "BenchmarkUtils.h"
+#include "SpeechAnalysisThread.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+namespace
+{
+    const double kSampleRate = 48000.0;
+    const int kBlockSize = 256;
+    const int kFrameSize = 480; // 10 ms
+    const double kRunSeconds = 2.0;
+
+    // Energy threshold plus a fixed busy-wait standing in for model inference.
+    class SyntheticDetector : public MLSpeechDetector
+    {
+    public:
+        explicit SyntheticDetector(double costMicroseconds) : cost(costMicroseconds) {}
+
+        bool detectSpeech(const float* samples, int numSamples, int) override
+        {
+            const auto t0 = bench::Clock::now();
+            float energy = 0.f;
+            for (int i = 0; i < numSamples; ++i)
+                energy += samples[i] * samples[i];
+            while (bench::secondsSince(t0) * 1.0e6 < cost) {}
+            return energy / float(numSamples) > 1.0e-4f;
+        }
+
+    private:
+        double cost;
+    };
+
+    struct LatencyResult
+    {
+        double medianMs, p99Ms, maxMs;
+        double pushNsMean, pushNsMax;
+        std::uint64_t dropped;
+    };
+
+    LatencyResult run(int numChannels, double costMicroseconds)
+    {
+        std::vector<std::vector<float>> signal;
+        std::vector<const float*> pointers;
+        for (int ch = 0; ch < numChannels; ++ch)
+            signal.push_back(bench::noise(kBlockSize, ch % 2 ? 0.1f : 0.001f, unsigned(ch + 1)));
+        for (auto& s : signal)
+            pointers.push_back(s.data());
+
+        SpeechAnalysisThread analysis;
+        analysis.start(std::make_shared<SyntheticDetector>(costMicroseconds), numChannels, kFrameSize);
+
+        const int numBlocks = int(kRunSeconds * kSampleRate / kBlockSize);
+        const auto blockPeriod = std::chrono::duration<double>(kBlockSize / kSampleRate);
+        std::vector<double> latencies;
+        latencies.reserve(size_t(numBlocks) * size_t(numChannels));
+        double pushTotal = 0.0, pushMax = 0.0;
+
+        const auto t0 = bench::Clock::now();
+        std::int64_t position = 0;
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            std::this_thread::sleep_until(t0 + std::chrono::duration_cast<bench::Clock::duration>(blockPeriod * block));
+
+            const auto p0 = bench::Clock::now();
+            analysis.pushAudio(pointers.data(), 0, kBlockSize, position);
+            const double pushNs = std::chrono::duration<double, std::nano>(bench::Clock::now() - p0).count();
+            pushTotal += pushNs;
+            pushMax = std::max(pushMax, pushNs);
+
+            // Collected at the start of the next block, as the engine does.
+            position += kBlockSize;
+            SpeechResult result;
+            while (analysis.popResult(result))
+                latencies.push_back(double(position - result.frameEnd) * 1000.0 / kSampleRate);
+        }
+        analysis.stop();
+
+        LatencyResult r {};
+        if (!latencies.empty())
+        {
+            std::sort(latencies.begin(), latencies.end());
+            r.medianMs = latencies[latencies.size() / 2];
+            r.p99Ms = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+            r.maxMs = latencies.back();
+        }
+        r.pushNsMean = pushTotal / numBlocks;
+        r.pushNsMax = pushMax;
+        r.dropped = analysis.getDroppedFrames();
+        return r;
+    }
+}
+
+int main()
+{
+    bench::flushDenormals();
+    std::printf("block %d, frame %d samples @ %.0f Hz, %.0f s real time per row\n", kBlockSize, kFrameSize,
+                kSampleRate, kRunSeconds);
+    std::printf("a block collects results every %.2f ms; a frame is %.2f ms\n\n",
+                kBlockSize * 1000.0 / kSampleRate, kFrameSize * 1000.0 / kSampleRate);
+    std::printf("%8s %10s %10s %10s %10s %12s %12s %8s\n", "channels", "infer us", "median ms", "p99 ms",
+                "max ms", "push ns avg", "push ns max", "dropped");
+
+    for (int numChannels : { 4, 16 })
+    {
+        for (double cost : { 0.0, 50.0, 400.0 })
+        {
+            LatencyResult r = run(numChannels, cost);
+            std::printf("%8d %10.0f %10.2f %10.2f %10.2f %12.0f %12.0f %8llu\n", numChannels, cost, r.medianMs,
+                        r.p99Ms, r.maxMs, r.pushNsMean, r.pushNsMax, (unsigned long long) r.dropped);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,319 @@
+// VadBenchmarks.cpp
+// Accuracy and cost of DspVoiceActivityDetector. The corpus is synthetic: a
+// "talker" (glottal pulse train through three vowel formants, syllabic
+// envelopes, the odd fricative) alternating talk spurts and pauses, mixed with
+// one noise at a given SNR. Ground truth is the talk spurt, gaps between
+// syllables included, so it is labelled per 10 ms frame the way a gate should
+// behave. Cost is the time of one detectSpeech() call per channel.
+#include "BenchmarkUtils.h"
+#include "DspVoiceActivityDetector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+
+namespace
+{
+    const double kSampleRate = 48000.0;
+    const int kFrameSize = 480; // 10 ms, as SpeechAnalysisThread uses
+    const double kCorpusSeconds = 60.0;
+    const float kTwoPi = 6.28318530718f;
+
+    // Two-pole resonator, unity gain at the centre.
+    struct Resonator
+    {
+        float a1 = 0.f, a2 = 0.f, g = 0.f, y1 = 0.f, y2 = 0.f;
+
+        void set(float hz, float bandwidthHz)
+        {
+            const float r = std::exp(-3.14159265f * bandwidthHz / float(kSampleRate));
+            a1 = 2.f * r * std::cos(kTwoPi * hz / float(kSampleRate));
+            a2 = -r * r;
+            g = 1.f - r;
+        }
+
+        float process(float x)
+        {
+            const float y = g * x + a1 * y1 + a2 * y2;
+            y2 = y1;
+            y1 = y;
+            return y;
+        }
+    };
+
+    struct Corpus
+    {
+        std::vector<float> speech;
+        std::vector<bool> frameIsSpeech;
+    };
+
+    Corpus makeSpeech(unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> uni(0.f, 1.f);
+        auto between = [&](float lo, float hi) { return lo + (hi - lo) * uni(rng); };
+
+        // F1, F2, F3 of a few vowels.
+        const float vowels[][3] = { { 730, 1090, 2440 }, { 270, 2290, 3010 }, { 530, 1840, 2480 },
+                                    { 300, 870, 2240 }, { 570, 840, 2410 }, { 660, 1720, 2410 } };
+
+        const auto total = size_t(kCorpusSeconds * kSampleRate);
+        Corpus c;
+        c.speech.assign(total, 0.f);
+        std::vector<bool> sampleIsSpeech(total, false);
+
+        Resonator formants[3];
+        float previousNoise = 0.f;
+        size_t pos = size_t(between(0.5f, 1.5f) * float(kSampleRate));
+        while (pos < total)
+        {
+            // One talk spurt: a run of syllables, then a pause.
+            const size_t spurtEnd = std::min(total, pos + size_t(between(1.0f, 3.5f) * float(kSampleRate)));
+            const float baseF0 = between(95.f, 220.f);
+            float phase = 0.f;
+
+            while (pos < spurtEnd)
+            {
+                const auto& v = vowels[int(uni(rng) * 5.999f)];
+                for (int k = 0; k < 3; ++k)
+                    formants[k].set(v[k] * between(0.9f, 1.1f), 80.f + 40.f * float(k));
+
+                const size_t syllableLength = size_t(between(0.12f, 0.30f) * float(kSampleRate));
+                const bool fricative = uni(rng) < 0.3f;
+                const size_t fricativeLength = fricative ? size_t(0.06 * kSampleRate) : 0;
+                const float level = between(0.3f, 1.0f);
+                const float glide = between(-0.3f, 0.3f);
+
+                for (size_t i = 0; i < syllableLength && pos < spurtEnd; ++i, ++pos)
+                {
+                    const float t = float(i) / float(syllableLength);
+                    float sample = 0.f;
+
+                    if (i < fricativeLength)
+                    {
+                        // Unvoiced onset: noise, crudely high-passed.
+                        const float n = between(-1.f, 1.f);
+                        sample = 0.15f * (n - previousNoise);
+                        previousNoise = n;
+                    }
+                    else
+                    {
+                        const float f0 = baseF0 * (1.f + glide * t) * (1.f + 0.01f * between(-1.f, 1.f));
+                        phase += f0 / float(kSampleRate);
+                        const float pulse = phase >= 1.f ? 1.f : 0.f;
+                        phase -= std::floor(phase);
+                        const float x = pulse * 60.f;
+                        sample = 0.5f * formants[0].process(x) + 0.35f * formants[1].process(x)
+                               + 0.15f * formants[2].process(x);
+                    }
+
+                    const float envelope = std::sin(3.14159265f * t);
+                    c.speech[pos] = level * envelope * sample;
+                    sampleIsSpeech[pos] = true;
+                }
+
+                // Short gap between syllables; still part of the spurt.
+                const size_t gap = size_t(between(0.02f, 0.12f) * float(kSampleRate));
+                for (size_t i = 0; i < gap && pos < spurtEnd; ++i, ++pos)
+                    sampleIsSpeech[pos] = true;
+            }
+            pos = std::min(total, pos + size_t(between(0.5f, 2.5f) * float(kSampleRate)));
+        }
+
+        // Normalise to about -20 dBFS RMS over the talk spurts.
+        double power = 0.0;
+        size_t talking = 0;
+        for (size_t i = 0; i < total; ++i)
+            if (sampleIsSpeech[i])
+            {
+                power += double(c.speech[i]) * c.speech[i];
+                ++talking;
+            }
+        const float gain = 0.1f / float(std::sqrt(power / double(std::max<size_t>(1, talking))));
+        for (auto& s : c.speech)
+            s *= gain;
+
+        // Mic self-noise / room tone around -75 dBFS: a real channel is never digital silence.
+        const auto roomTone = bench::noise(int(total), 3.0e-4f, seed + 1);
+        for (size_t i = 0; i < total; ++i)
+            c.speech[i] += roomTone[i];
+
+        for (size_t f = 0; f + kFrameSize <= total; f += kFrameSize)
+        {
+            // A frame is speech if most of it lies inside a spurt.
+            size_t count = 0;
+            for (size_t i = f; i < f + kFrameSize; ++i)
+                count += sampleIsSpeech[i] ? 1 : 0;
+            c.frameIsSpeech.push_back(count * 2 > kFrameSize);
+        }
+        return c;
+    }
+
+    using NoiseFn = std::function<std::vector<float>(size_t, unsigned)>;
+
+    std::vector<float> whiteNoise(size_t n, unsigned seed)
+    {
+        return bench::noise(int(n), 1.f, seed);
+    }
+
+    std::vector<float> pinkNoise(size_t n, unsigned seed)
+    {
+        // Paul Kellet's economy filter.
+        auto v = bench::noise(int(n), 1.f, seed);
+        float b0 = 0.f, b1 = 0.f, b2 = 0.f;
+        for (auto& x : v)
+        {
+            b0 = 0.99765f * b0 + x * 0.0990460f;
+            b1 = 0.96300f * b1 + x * 0.2965164f;
+            b2 = 0.57000f * b2 + x * 1.0526913f;
+            x = b0 + b1 + b2 + x * 0.1848f;
+        }
+        return v;
+    }
+
+    std::vector<float> hum(size_t n, unsigned)
+    {
+        std::vector<float> v(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const float t = float(double(i) / kSampleRate);
+            v[i] = std::sin(kTwoPi * 50.f * t) + 0.5f * std::sin(kTwoPi * 150.f * t) + 0.25f * std::sin(kTwoPi * 250.f * t);
+        }
+        return v;
+    }
+
+    // Sustained chords, changing every couple of seconds: tonal, in the speech band, but steady.
+    std::vector<float> musicChord(size_t n, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        const float roots[] = { 220.f, 196.f, 261.6f, 174.6f };
+        std::vector<float> v(n);
+        const size_t chordLength = size_t(2.0 * kSampleRate);
+        float phases[3][4] = {};
+        for (size_t i = 0; i < n; ++i)
+        {
+            const float root = roots[(i / chordLength) % 4];
+            const float notes[3] = { root, root * 1.26f, root * 1.5f };
+            float s = 0.f;
+            for (int k = 0; k < 3; ++k)
+                for (int h = 0; h < 4; ++h)
+                {
+                    phases[k][h] += notes[k] * float(h + 1) / float(kSampleRate);
+                    phases[k][h] -= std::floor(phases[k][h]);
+                    s += std::sin(kTwoPi * phases[k][h]) / float(h + 1);
+                }
+            v[i] = s;
+        }
+        return v;
+    }
+
+    // Keyboard-like clicks: short decaying noise bursts at random intervals.
+    std::vector<float> clicks(size_t n, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> uni(-1.f, 1.f);
+        std::exponential_distribution<float> interval(8.f); // about 8 per second
+        std::vector<float> v(n, 0.f);
+        size_t pos = 0;
+        while (true)
+        {
+            pos += size_t(interval(rng) * float(kSampleRate)) + 1;
+            if (pos >= n)
+                break;
+            const size_t length = size_t(0.008 * kSampleRate);
+            for (size_t i = 0; i < length && pos + i < n; ++i)
+                v[pos + i] += uni(rng) * std::exp(-float(i) / (0.0015f * float(kSampleRate)));
+        }
+        return v;
+    }
+
+    struct Score
+    {
+        double accuracy, recall, falseAlarm;
+    };
+
+    Score evaluate(const Corpus& corpus, const std::vector<float>& noiseSignal, float snrDb)
+    {
+        // Speech is at -20 dBFS over its spurts; scale the noise to match the SNR.
+        double power = 0.0;
+        for (float x : noiseSignal)
+            power += double(x) * x;
+        const float noiseRms = float(std::sqrt(power / double(noiseSignal.size())));
+        const float gain = noiseRms > 0.f ? 0.1f * std::pow(10.f, -snrDb / 20.f) / noiseRms : 0.f;
+
+        std::vector<float> mix(corpus.speech.size());
+        for (size_t i = 0; i < mix.size(); ++i)
+            mix[i] = corpus.speech[i] + gain * noiseSignal[i];
+
+        DspVoiceActivityDetector vad(kSampleRate, 1);
+        size_t correct = 0, hits = 0, speechFrames = 0, falseAlarms = 0, silentFrames = 0;
+        for (size_t f = 0; f < corpus.frameIsSpeech.size(); ++f)
+        {
+            const bool decision = vad.detectSpeech(mix.data() + f * kFrameSize, kFrameSize, 0);
+            const bool truth = corpus.frameIsSpeech[f];
+            correct += decision == truth ? 1 : 0;
+            if (truth)
+            {
+                ++speechFrames;
+                hits += decision ? 1 : 0;
+            }
+            else
+            {
+                ++silentFrames;
+                falseAlarms += decision ? 1 : 0;
+            }
+        }
+        return { 100.0 * double(correct) / double(corpus.frameIsSpeech.size()),
+                 100.0 * double(hits) / double(std::max<size_t>(1, speechFrames)),
+                 100.0 * double(falseAlarms) / double(std::max<size_t>(1, silentFrames)) };
+    }
+}
+
+int main()
+{
+    bench::flushDenormals();
+
+    const Corpus corpus = makeSpeech(7);
+    const size_t n = corpus.speech.size();
+    size_t speechFrames = 0;
+    for (bool b : corpus.frameIsSpeech)
+        speechFrames += b ? 1 : 0;
+
+    std::printf("synthetic corpus: %.0f s, %zu frames of %d samples, %.0f%% speech\n\n", kCorpusSeconds,
+                corpus.frameIsSpeech.size(), kFrameSize, 100.0 * double(speechFrames) / double(corpus.frameIsSpeech.size()));
+    std::printf("%-12s %8s %10s %10s %12s\n", "noise", "SNR dB", "accuracy", "recall", "false alarm");
+
+    const std::pair<const char*, NoiseFn> noises[] = {
+        { "none", [](size_t len, unsigned) { return std::vector<float>(len, 0.f); } },
+        { "white", whiteNoise }, { "pink", pinkNoise }, { "hum", hum },
+        { "music", musicChord }, { "clicks", clicks },
+    };
+    for (const auto& noise : noises)
+    {
+        const auto signal = noise.second(n, 11);
+        for (float snr : { 20.f, 10.f })
+        {
+            const Score s = evaluate(corpus, signal, snr);
+            std::printf("%-12s %8.0f %9.1f%% %9.1f%% %11.1f%%\n", noise.first, snr, s.accuracy, s.recall, s.falseAlarm);
+            if (noise.first == noises[0].first)
+                break; // clean speech has no SNR
+        }
+    }
+
+    // Cost: one detectSpeech() call per channel per frame, on the clean corpus.
+    std::printf("\n%10s %14s %16s\n", "frame", "ns per call", "ns per 256 smp");
+    for (int frameSize : { 256, 480, 960 })
+    {
+        DspVoiceActivityDetector vad(kSampleRate, 1);
+        size_t offset = 0;
+        const double ns = bench::nsPerCall([&] {
+            offset += size_t(frameSize);
+            if (offset + size_t(frameSize) > n)
+                offset = 0;
+            bench::doNotOptimise(vad.detectSpeech(corpus.speech.data() + offset, frameSize, 0) ? 1.f : 0.f);
+        });
+        std::printf("%10d %14.0f %16.0f\n", frameSize, ns, ns * 256.0 / frameSize);
+    }
+    return 0;
+}
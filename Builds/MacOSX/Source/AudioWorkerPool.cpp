@@ -0,0 +1,242 @@
+// AudioWorkerPool.cpp
+#include "AudioWorkerPool.h"
+#include "RealtimeSafety.h"
+
+#if defined(__APPLE__)
+ #include <mach/mach.h>
+ #include <mach/mach_time.h>
+ #include <mach/thread_policy.h>
+ #include <pthread.h>
+#else
+ #include <cerrno>
+ #include <pthread.h>
+ #include <sched.h>
+ #include <semaphore.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+ #include <immintrin.h>
+#endif
+
+namespace
+{
+    // How long an idle worker polls for the next job before going to sleep.
+    // A few microseconds: long enough to bridge the gaps inside one processBlock().
+    constexpr int kSpinIterations = 4096;
+
+    // How often a spinning audio thread yields while waiting on the barrier, so a
+    // worker sharing its core still gets scheduled.
+    constexpr int kYieldInterval = 1024;
+
+   #if defined(__APPLE__)
+    // The share of each period a worker may compute for before the scheduler may
+    // demote it. The workers split one block's work, so they need well under it.
+    constexpr double kComputationShare = 0.5;
+   #else
+    // SCHED_FIFO this far below the maximum. Any SCHED_FIFO priority preempts every
+    // normal thread; staying near the top keeps the workers level with, or above,
+    // the host's audio thread, which is what waits on them.
+    constexpr int kFifoPriorityBelowMax = 10;
+   #endif
+
+    inline void cpuRelax()
+    {
+       #if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+        _mm_pause();
+       #elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+       #endif
+    }
+
+    // work word layout: generation (32) | next task (16) | task count (16)
+    inline std::uint64_t pack(std::uint32_t generation, int next, int count)
+    {
+        return (std::uint64_t(generation) << 32) | (std::uint64_t(next) << 16) | std::uint64_t(count);
+    }
+
+    inline std::uint32_t generationOf(std::uint64_t w) { return std::uint32_t(w >> 32); }
+    inline int nextOf(std::uint64_t w)                 { return int((w >> 16) & 0xffff); }
+    inline int countOf(std::uint64_t w)                { return int(w & 0xffff); }
+}
+
+// Counting semaphore; post() is a single non-blocking call so it is safe from the audio thread.
+class AudioWorkerPool::Semaphore
+{
+public:
+   #if defined(__APPLE__)
+    Semaphore()  { semaphore_create(mach_task_self(), &sem, SYNC_POLICY_FIFO, 0); }
+    ~Semaphore() { semaphore_destroy(mach_task_self(), sem); }
+    void post()  { semaphore_signal(sem); }
+    void wait()  { semaphore_wait(sem); }
+   #else
+    Semaphore()  { sem_init(&sem, 0, 0); }
+    ~Semaphore() { sem_destroy(&sem); }
+    void post()  { sem_post(&sem); }
+    void wait()  { while (sem_wait(&sem) != 0 && errno == EINTR) {} }
+   #endif
+
+    Semaphore(const Semaphore&) = delete;
+    Semaphore& operator=(const Semaphore&) = delete;
+
+private:
+   #if defined(__APPLE__)
+    semaphore_t sem;
+   #else
+    sem_t sem;
+   #endif
+};
+
+AudioWorkerPool::AudioWorkerPool() = default;
+
+AudioWorkerPool::~AudioWorkerPool()
+{
+    stop();
+}
+
+bool AudioWorkerPool::start(int numWorkers, double periodSeconds)
+{
+    stop();
+    quit.store(false);
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto w = std::make_unique<Worker>();
+        w->wake = std::make_unique<Semaphore>();
+        workers.push_back(std::move(w));
+    }
+
+    // The generation is read here, not by the new thread: one that first ran after
+    // a job or stop() was posted would take that as already seen and sleep through it.
+    const std::uint32_t startGeneration = generationOf(work.load());
+    for (auto& w : workers)
+    {
+        Worker* worker = w.get();
+        threads.emplace_back([this, worker, startGeneration] { workerLoop(*worker, startGeneration); });
+    }
+
+    for (auto& t : threads)
+    {
+        if (! setRealtimePriority(t, periodSeconds))
+        {
+            stop();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AudioWorkerPool::setRealtimePriority(std::thread& t, double periodSeconds)
+{
+   #if defined(__APPLE__)
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    const double ticksPerSecond = 1.0e9 * double(timebase.denom) / double(timebase.numer);
+    const auto period = static_cast<uint32_t>(periodSeconds * ticksPerSecond);
+
+    thread_time_constraint_policy_data_t policy;
+    policy.period = period;
+    policy.computation = static_cast<uint32_t>(period * kComputationShare);
+    policy.constraint = period;
+    policy.preemptible = true;
+    return thread_policy_set(pthread_mach_thread_np(t.native_handle()), THREAD_TIME_CONSTRAINT_POLICY,
+                             reinterpret_cast<thread_policy_t>(&policy),
+                             THREAD_TIME_CONSTRAINT_POLICY_COUNT) == KERN_SUCCESS;
+   #else
+    (void) periodSeconds;
+    sched_param param {};
+    param.sched_priority = sched_get_priority_max(SCHED_FIFO) - kFifoPriorityBelowMax;
+    return pthread_setschedparam(t.native_handle(), SCHED_FIFO, &param) == 0;
+   #endif
+}
+
+void AudioWorkerPool::stop()
+{
+    if (threads.empty())
+        return;
+
+    // An empty job with a new generation wakes everyone; they see quit and exit.
+    quit.store(true);
+    work.store(pack(++generation, 0, 0));
+    for (auto& w : workers)
+        w->wake->post();
+
+    for (auto& t : threads)
+        t.join();
+
+    threads.clear();
+    workers.clear();
+}
+
+void AudioWorkerPool::run(int numTasks, TaskFn fn, void* context)
+{
+    taskFn = fn;
+    taskContext = context;
+    pending.store(numTasks, std::memory_order_relaxed);
+    const std::uint32_t gen = ++generation;
+    work.store(pack(gen, 0, numTasks));
+
+    for (auto& w : workers)
+        if (w->sleeping.exchange(false))
+            w->wake->post();
+
+    runTasks(gen);
+
+    // Barrier: nothing after parallelFor() may run until every task is done.
+    for (int spins = 1; pending.load(std::memory_order_acquire) != 0; ++spins)
+    {
+        cpuRelax();
+        if (spins % kYieldInterval == 0)
+            std::this_thread::yield();
+    }
+}
+
+void AudioWorkerPool::runTasks(std::uint32_t gen)
+{
+    RealtimeSafety::ScopedNoAllocation noAlloc;
+
+    std::uint64_t w = work.load(std::memory_order_acquire);
+    while (generationOf(w) == gen && nextOf(w) < countOf(w))
+    {
+        if (work.compare_exchange_weak(w, w + (std::uint64_t(1) << 16),
+                                       std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            taskFn(taskContext, nextOf(w));
+            pending.fetch_sub(1, std::memory_order_release);
+            w = work.load(std::memory_order_acquire);
+        }
+    }
+}
+
+void AudioWorkerPool::workerLoop(Worker& worker, std::uint32_t seen)
+{
+    for (;;)
+    {
+        std::uint64_t w = work.load(std::memory_order_acquire);
+        for (int spins = 1; generationOf(w) == seen && spins <= kSpinIterations; ++spins)
+        {
+            // At realtime priority a spinning worker would otherwise hold its core
+            // against an audio thread of the same priority sharing it.
+            cpuRelax();
+            if (spins % kYieldInterval == 0)
+                std::this_thread::yield();
+            w = work.load(std::memory_order_acquire);
+        }
+
+        if (generationOf(w) == seen)
+        {
+            // Publish that we're about to sleep, then re-check so a job posted in
+            // between is never missed. A stray post only costs one extra loop.
+            worker.sleeping.store(true);
+            if (generationOf(work.load()) == seen)
+                worker.wake->wait();
+            worker.sleeping.store(false, std::memory_order_relaxed);
+            continue;
+        }
+
+        if (quit.load())
+            return;
+
+        seen = generationOf(w);
+        runTasks(seen);
+    }
+}
@@ -0,0 +1,111 @@
+// AudioWorkerPool.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+    AudioWorkerPool:
+    - Pre-spawned helper threads that let one processBlock() fan per-channel work
+      out across cores. start()/stop() run on the message thread (from prepare());
+      parallelFor() runs on the audio thread.
+    - parallelFor() never allocates or locks. A job is published through a single
+      64-bit atomic (generation | next task | task count), workers and the calling
+      thread claim tasks with compare-and-swap, and the caller spins until every
+      task has finished, so returning from parallelFor() is a barrier.
+    - Idle workers spin briefly for the next job, then sleep on a semaphore. Waking
+      one is a single non-blocking post from the audio thread.
+    - The audio thread waits on the workers, so they run at realtime priority:
+      a Mach time-constraint policy sized to the host block period on Apple,
+      SCHED_FIFO elsewhere. If the OS refuses (no CAP_SYS_NICE / RLIMIT_RTPRIO
+      on Linux, say), the workers are stopped again and parallelFor() runs
+      everything on the calling thread: a normal-priority worker preempted
+      mid-task would stall the audio callback behind it.
+*/
+class AudioWorkerPool
+{
+public:
+    AudioWorkerPool();
+    ~AudioWorkerPool();
+
+    // Message thread. Stops any running workers and spawns numWorkers new ones (0 = none),
+    // at realtime priority for a callback every periodSeconds. Returns false, with no
+    // workers running, if realtime priority was refused.
+    bool start(int numWorkers, double periodSeconds);
+    void stop();
+
+    int getNumWorkers() const { return static_cast<int>(threads.size()); }
+
+    // Calls fn(begin, end) over [0, numItems) in ranges of at most grain items, on the
+    // workers and the calling thread. Returns once all ranges are done.
+    template <typename Fn>
+    void parallelFor(int numItems, int grain, Fn&& fn)
+    {
+        if (numItems <= 0)
+            return;
+
+        grain = grain > 0 ? grain : 1;
+        if ((numItems + grain - 1) / grain > maxTasks)
+            grain = (numItems + maxTasks - 1) / maxTasks;
+        const int numTasks = (numItems + grain - 1) / grain;
+        if (numTasks == 1 || threads.empty())
+        {
+            fn(0, numItems);
+            return;
+        }
+
+        using Job = RangeJob<std::remove_reference_t<Fn>>;
+        Job job { &fn, numItems, grain };
+        run(numTasks, &Job::invoke, &job);
+    }
+
+    // Most tasks one parallelFor() can split into.
+    static constexpr int maxTasks = 0xffff;
+
+private:
+    using TaskFn = void (*)(void* context, int task);
+
+    template <typename Fn>
+    struct RangeJob
+    {
+        Fn* fn;
+        int numItems, grain;
+
+        static void invoke(void* context, int task)
+        {
+            auto& j = *static_cast<RangeJob*>(context);
+            const int begin = task * j.grain;
+            const int end = begin + j.grain < j.numItems ? begin + j.grain : j.numItems;
+            (*j.fn)(begin, end);
+        }
+    };
+
+    class Semaphore;
+
+    struct Worker
+    {
+        std::unique_ptr<Semaphore> wake;
+        std::atomic<bool> sleeping {false};
+    };
+
+    void run(int numTasks, TaskFn fn, void* context);
+    void runTasks(std::uint32_t generation);
+    void workerLoop(Worker& w, std::uint32_t seen);
+    static bool setRealtimePriority(std::thread& t, double periodSeconds);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    // Current job. taskFn/taskContext are only read after a task of the matching
+    // generation has been claimed, so the caller can rewrite them between jobs.
+    std::atomic<std::uint64_t> work {0};
+    std::atomic<int> pending {0};
+    std::atomic<bool> quit {false};
+    TaskFn taskFn = nullptr;
+    void* taskContext = nullptr;
+    std::uint32_t generation = 0;
+};
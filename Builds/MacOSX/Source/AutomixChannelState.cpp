@@ -0,0 +1,220 @@
+// AutomixChannelState.cpp
+#include "AutomixChannelState.h"
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace
+{
+    // Field counts behind the views: mute, bypass, automix, gateActive, speechActive, bleed;
+    // sensDb, faderDb, sensLin, faderLin, blockRms, shortTermRMS, longTermRMS, gateEnv,
+    // finalGain, appliedGain, targetGain, sumSquares.
+    constexpr int kFlagFields = 6;
+    constexpr int kValueFields = 12;
+
+    // Each pass is instantiated once per fixed channel count (N > 0) and once with
+    // N = 0, which takes the count at run time.
+    //
+    // The passes take every array as a __restrict parameter. Without that GCC has to
+    // prove a dozen arrays disjoint at run time, gives up, and leaves the loop scalar.
+    template <int N>
+    void gatePass(int n, const AutomixChannelState::GateCoefficients& k, bool smoothMuted, bool useSpeech,
+                  bool useCrossTalk, const std::uint8_t* __restrict mute, const std::uint8_t* __restrict bypass,
+                  const std::uint8_t* __restrict automix, const std::uint8_t* __restrict speech,
+                  const std::uint8_t* __restrict bleed,
+                  const float* __restrict blockRms, const float* __restrict sensLin,
+                  float* __restrict stRms, float* __restrict ltRms, float* __restrict gateEnv,
+                  std::uint8_t* __restrict gateActive)
+    {
+        const int numCh = N > 0 ? N : n;
+
+        // Copied out of k for the same reason: the loop must not reload them after each store.
+        const float stCoef = k.stCoef, ltCoef = k.ltCoef;
+        const float gateOnLin = k.gateOnLin, gateOffLin = k.gateOffLin;
+        const float attCoeff = k.attCoeff, relCoeff = k.relCoeff;
+
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            const bool measured = smoothMuted | (mute[ch] == 0);
+            const bool gated = (mute[ch] == 0) & (bypass[ch] == 0) & (automix[ch] != 0);
+            const float rms = blockRms[ch];
+
+            const float st = measured ? stCoef * stRms[ch] + (1.f - stCoef) * rms : stRms[ch];
+            ltRms[ch] = measured ? ltCoef * ltRms[ch] + (1.f - ltCoef) * rms : ltRms[ch];
+            stRms[ch] = st;
+
+            // Hysteresis: an open gate closes at the lower threshold.
+            const bool speechOk = !useSpeech | (speech[ch] != 0);
+            const bool ownSource = !useCrossTalk | (bleed[ch] == 0);
+            const float threshold = gateActive[ch] ? gateOffLin : gateOnLin;
+            const bool wantOpen = gated & speechOk & ownSource & (st * sensLin[ch] > threshold);
+
+            const float env = gateEnv[ch];
+            const float next = env + (wantOpen ? attCoeff : relCoeff) * ((wantOpen ? 1.f : 0.f) - env);
+            gateEnv[ch] = gated ? next : env;
+            gateActive[ch] = gated & (next > 0.5f);
+        }
+    }
+
+    template <int N>
+    void gainPass(int n, float closeLin, float master, float maxLin,
+                  const std::uint8_t* __restrict mute, const std::uint8_t* __restrict bypass,
+                  const std::uint8_t* __restrict automix, const std::uint8_t* __restrict gateActive,
+                  const float* __restrict blockRms, const float* __restrict sensLin,
+                  const float* __restrict faderLin, const float* __restrict stRms,
+                  const float* __restrict gateEnv, float* __restrict finalGain)
+    {
+        const int numCh = N > 0 ? N : n;
+
+        // Kept in channel order so the result doesn't depend on vector width.
+        float sumActive = 0.f;
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            const bool gated = (mute[ch] == 0) & (bypass[ch] == 0) & (automix[ch] != 0);
+            if (gated & (gateActive[ch] != 0))
+                sumActive += stRms[ch] + 1e-9f;
+        }
+
+        const float equalShare = 1.f / static_cast<float>(numCh);
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            const bool gated = (mute[ch] == 0) & (bypass[ch] == 0) & (automix[ch] != 0);
+            const float share = sumActive < 1e-9f ? equalShare : (stRms[ch] + 1e-9f) / sumActive;
+            const float mixGain = (gateActive[ch] ? share : closeLin * gateEnv[ch]) * faderLin[ch] * master;
+            const float passGain = blockRms[ch] * sensLin[ch] * faderLin[ch] * master;
+            const float g = mute[ch] ? 0.f : (gated ? mixGain : passGain);
+            finalGain[ch] = std::min(g, maxLin);
+        }
+    }
+
+    template <int N>
+    int loudestPass(int n, const std::uint8_t* gateActive, const float* stRms, const float* sensLin)
+    {
+        const int numCh = N > 0 ? N : n;
+
+        int loudest = -1;
+        float loudestLevel = -1.f;
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            const float level = gateActive[ch] ? stRms[ch] * sensLin[ch] : -1.f;
+            if (level > loudestLevel)
+            {
+                loudestLevel = level;
+                loudest = ch;
+            }
+        }
+        return loudest;
+    }
+}
+
+struct AutomixChannelState::Storage
+{
+    virtual ~Storage() = default;
+};
+
+template <int N>
+struct AutomixChannelState::FixedStorage : Storage
+{
+    std::array<std::uint8_t, kFlagFields * N> flags {};
+    alignas(64) std::array<float, kValueFields * N> values {};
+};
+
+struct AutomixChannelState::DynamicStorage : Storage
+{
+    std::vector<std::uint8_t> flags;
+    std::vector<float> values;
+};
+
+template <int N>
+AutomixChannelState::Passes AutomixChannelState::passesFor()
+{
+    Passes p;
+    p.gates = [](AutomixChannelState& s, const GateCoefficients& k, bool smoothMuted, bool useSpeech, bool useCrossTalk)
+    {
+        gatePass<N>(s.count, k, smoothMuted, useSpeech, useCrossTalk, s.mute, s.bypass, s.automix, s.speechActive,
+                    s.bleed, s.blockRms, s.sensLin, s.shortTermRMS, s.longTermRMS, s.gateEnv, s.gateActive);
+    };
+    p.gains = [](AutomixChannelState& s, float closeLin, float master, float maxLin)
+    {
+        gainPass<N>(s.count, closeLin, master, maxLin, s.mute, s.bypass, s.automix, s.gateActive,
+                    s.blockRms, s.sensLin, s.faderLin, s.shortTermRMS, s.gateEnv, s.finalGain);
+    };
+    p.loudest = [](const AutomixChannelState& s)
+    {
+        return loudestPass<N>(s.count, s.gateActive, s.shortTermRMS, s.sensLin);
+    };
+    return p;
+}
+
+template <int N>
+void AutomixChannelState::useFixedStorage()
+{
+    auto fixed = std::make_unique<FixedStorage<N>>();
+    bind(fixed->flags.data(), fixed->values.data(), N);
+    storage = std::move(fixed);
+    passes = passesFor<N>();
+    fixedSize = true;
+}
+
+AutomixChannelState::AutomixChannelState()
+    : passes(passesFor<0>())
+{
+}
+
+AutomixChannelState::~AutomixChannelState() = default;
+
+void AutomixChannelState::resize(int numChannels, bool allowFixedSize)
+{
+    count = std::max(0, numChannels);
+    fixedSize = false;
+
+    switch (allowFixedSize ? count : 0)
+    {
+        case 4:  useFixedStorage<4>();  break;
+        case 8:  useFixedStorage<8>();  break;
+        case 16: useFixedStorage<16>(); break;
+        case 32: useFixedStorage<32>(); break;
+        default:
+        {
+            // Round each field up to 16 floats so every array starts on its own cache line.
+            const std::size_t stride = (static_cast<std::size_t>(count) + 15) & ~std::size_t(15);
+            auto dynamic = std::make_unique<DynamicStorage>();
+            dynamic->flags.assign(kFlagFields * stride, 0);
+            dynamic->values.assign(kValueFields * stride, 0.f);
+            bind(dynamic->flags.data(), dynamic->values.data(), stride);
+            storage = std::move(dynamic);
+            passes = passesFor<0>();
+            break;
+        }
+    }
+
+    std::fill(automix, automix + count, std::uint8_t(1));
+    std::fill(sensLin, sensLin + count, 1.f);
+    std::fill(faderLin, faderLin + count, 1.f);
+    std::fill(finalGain, finalGain + count, 1.f);
+    std::fill(appliedGain, appliedGain + count, 1.f);
+    std::fill(targetGain, targetGain + count, 1.f);
+}
+
+void AutomixChannelState::bind(std::uint8_t* flags, float* values, std::size_t stride)
+{
+    mute         = flags;
+    bypass       = flags + stride;
+    automix      = flags + 2 * stride;
+    gateActive   = flags + 3 * stride;
+    speechActive = flags + 4 * stride;
+    bleed        = flags + 5 * stride;
+
+    sensDb       = values;
+    faderDb      = values + stride;
+    sensLin      = values + 2 * stride;
+    faderLin     = values + 3 * stride;
+    blockRms     = values + 4 * stride;
+    shortTermRMS = values + 5 * stride;
+    longTermRMS  = values + 6 * stride;
+    gateEnv      = values + 7 * stride;
+    finalGain    = values + 8 * stride;
+    appliedGain  = values + 9 * stride;
+    targetGain   = values + 10 * stride;
+    sumSquares   = values + 11 * stride;
+}
@@ -0,0 +1,110 @@
+// AutomixChannelState.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+    AutomixChannelState:
+    - Structure-of-arrays layout for per-channel settings and DSP state.
+    - Every field is one contiguous array indexed by channel, so the gate and
+      gain-share passes walk a handful of dense float/byte arrays and the
+      compiler can vectorise across channels. There is no fixed channel limit;
+      cost grows linearly with the count passed to resize().
+    - Flags are uint8_t (0/1) rather than bool so they can be read as masks.
+    - updateGates()/computeGains()/loudestOpenGate() are the per-block passes
+      shared by both engines; they are branch-free over channels.
+    - The usual deployment sizes (4, 8, 16 and 32 channels) have compile-time
+      specialisations. For those, resize() picks std::array storage and passes
+      instantiated for that count, so the loops unroll with no remainder
+      handling. Other counts use the dynamic versions. The fields below are
+      views into whichever storage is active.
+*/
+struct AutomixChannelState
+{
+    AutomixChannelState();
+    ~AutomixChannelState();
+
+    AutomixChannelState(const AutomixChannelState&) = delete;
+    AutomixChannelState& operator=(const AutomixChannelState&) = delete;
+
+    // Message thread only (from prepare()). Resets all state to defaults.
+    // allowFixedSize = false forces the dynamic path (for benchmarks).
+    void resize(int numChannels, bool allowFixedSize = true);
+
+    int size() const { return count; }
+
+    // True when resize() picked a compile-time specialisation.
+    bool isFixedSize() const { return fixedSize; }
+
+    // Per-block constants for updateGates(), all in the linear domain.
+    struct GateCoefficients
+    {
+        float stCoef = 0.f, ltCoef = 0.f;       // RMS smoothing
+        float gateOnLin = 0.f, gateOffLin = 0.f; // thresholds incl. hysteresis
+        float attCoeff = 0.f, relCoeff = 0.f;    // envelope attack/release
+    };
+
+    // RMS smoothing and gate envelopes for all channels from blockRms.
+    // smoothMuted: muted channels still update their meters.
+    // useSpeech:   a gate may only open while speechActive is set.
+    // useCrossTalk: a gate may only open while bleed is clear.
+    void updateGates(const GateCoefficients& k, bool smoothMuted, bool useSpeech, bool useCrossTalk)
+    {
+        passes.gates(*this, k, smoothMuted, useSpeech, useCrossTalk);
+    }
+
+    // Gain sharing across the open gates, fader/master, and a clamp at maxLin.
+    // Muted channels get 0, bypassed/automix-off channels follow their RMS.
+    void computeGains(float closeLin, float master, float maxLin)
+    {
+        passes.gains(*this, closeLin, master, maxLin);
+    }
+
+    // Open gate with the highest sensitivity-weighted short-term RMS, or -1 if none.
+    int loudestOpenGate() const { return passes.loudest(*this); }
+
+    // Settings, copied in by the engine from its parameter snapshot:
+    std::uint8_t* mute = nullptr;
+    std::uint8_t* bypass = nullptr;
+    std::uint8_t* automix = nullptr;
+    float* sensDb = nullptr;
+    float* faderDb = nullptr;
+    float* sensLin = nullptr;   // cached dbToLinear(sensDb)
+    float* faderLin = nullptr;  // cached dbToLinear(faderDb)
+
+    // DSP state:
+    float* blockRms = nullptr;      // RMS of the latest control block, input to updateGates()
+    float* shortTermRMS = nullptr;
+    float* longTermRMS = nullptr;
+    float* gateEnv = nullptr;       // attack/release envelope
+    std::uint8_t* gateActive = nullptr;
+    float* finalGain = nullptr;     // output of computeGains()
+    float* appliedGain = nullptr;   // gain at the start of the current control block
+    float* targetGain = nullptr;    // gain the current control block ramps to
+    float* sumSquares = nullptr;    // detector input so far in the current control block
+    std::uint8_t* speechActive = nullptr; // latest ML/VAD decision
+    std::uint8_t* bleed = nullptr;        // latest cross-talk decision: only another mic's talker
+
+private:
+    struct Storage;
+    template <int N> struct FixedStorage;
+    struct DynamicStorage;
+
+    struct Passes
+    {
+        void (*gates)(AutomixChannelState&, const GateCoefficients&, bool, bool, bool);
+        void (*gains)(AutomixChannelState&, float, float, float);
+        int (*loudest)(const AutomixChannelState&);
+    };
+
+    template <int N> static Passes passesFor();
+    template <int N> void useFixedStorage();
+    void bind(std::uint8_t* flags, float* values, std::size_t stride);
+
+    std::unique_ptr<Storage> storage;
+    Passes passes;
+    int count = 0;
+    bool fixedSize = false;
+};
@@ -0,0 +1,96 @@
+// AutomixParameters.h
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+    AutomixParameters:
+    - Every user-facing engine setting in one plain struct, published to the
+      audio thread as a whole through a TripleBuffer.
+    - The per-channel vectors are sized in prepare(). Copying a snapshot into a
+      slot of the same size reuses that slot's storage, so publishing never
+      allocates once prepared.
+    - version goes up with every publish. The audio thread recomputes its derived
+      coefficients only when it changes.
+*/
+struct AutomixParameters
+{
+    std::uint32_t version = 0;
+
+    float masterGain = 1.f;
+    float gateThreshold = -40.f;
+    float gateHysteresis = 3.f;
+    float gateCloseDb = -30.f;
+    float gateAttackMs = 10.f;
+    float gateReleaseMs = 200.f;
+    bool  lastMicOn = true;
+
+    float shortTermMs = 20.f;
+    float longTermMs = 500.f;
+    float lookaheadMs = 0.f;
+    bool  zeroLatency = false;
+    int   controlBlockSize = 64;  // samples per gate/gain decision
+
+    bool  linkLeveler = false;
+    float levelerRangeDb = 12.f;
+
+    bool  useAdaptiveThreshold = false;
+    float sidechainInfluence = 0.f;
+
+    bool  duckingEnabled = false;
+    float duckThresholdDb = -40.f;  // sidechain level that starts ducking
+    float duckDepthDb = 12.f;       // attenuation while ducked
+    float duckAttackMs = 20.f;
+    float duckReleaseMs = 500.f;
+
+    bool  useMLSpeechDetection = false;
+    bool  useCrossTalkSuppression = false;
+
+    int workerThreads = -1;     // -1 = one fewer than the number of cores, up to 7
+    int parallelThreshold = 64; // channels
+
+    // Per channel:
+    std::vector<std::uint8_t> mute;
+    std::vector<std::uint8_t> bypass;
+    std::vector<std::uint8_t> automix;
+    std::vector<float> sensDb;
+    std::vector<float> faderDb;
+
+    // Output matrix for the mixing processBlock(): numOutputs linear gains per
+    // channel, one row per channel. By default every channel feeds every output
+    // at unity, i.e. the mono mix on each output.
+    int numOutputs = 0;
+    std::vector<float> outputGains;
+
+    int getNumChannels() const { return static_cast<int>(mute.size()); }
+
+    // Message thread. Keeps the settings of channels that still exist; new ones get defaults.
+    void resizeChannels(int numChannels)
+    {
+        const auto n = static_cast<std::size_t>(numChannels > 0 ? numChannels : 0);
+        mute.resize(n, 0);
+        bypass.resize(n, 0);
+        automix.resize(n, 1);
+        sensDb.resize(n, 0.f);
+        faderDb.resize(n, 0.f);
+        outputGains.resize(n * static_cast<std::size_t>(numOutputs), 1.f);
+    }
+
+    // Message thread. Keeps the gains into outputs that still exist; new ones get unity.
+    void resizeOutputs(int numOutputChannels)
+    {
+        const auto rows = mute.size();
+        const auto oldCols = static_cast<std::size_t>(numOutputs);
+        const auto cols = static_cast<std::size_t>(numOutputChannels > 0 ? numOutputChannels : 0);
+        std::vector<float> gains(rows * cols, 1.f);
+        for (std::size_t ch = 0; ch < rows; ++ch)
+            for (std::size_t out = 0; out < std::min(cols, oldCols); ++out)
+                gains[ch * cols + out] = outputGains[ch * oldCols + out];
+        outputGains = std::move(gains);
+        numOutputs = static_cast<int>(cols);
+    }
+};
@@ -50,11 +50,16 @@ void ChannelStripComponent::paint(juce::Graphics& g)
                                     juce::Colours::green, meterArea.getRight(), meterArea.getBottom(), false);
     g.setGradientFill(meterGrad);
     g.fillRect(meterArea);
+
+    // Peak tick above the RMS bar
+    float peakY = bounds.getBottom() - 4 - juce::jmin(peakLevel, 1.0f) * bounds.getHeight();
+    g.setColour(juce::Colours::yellow);
+    g.fillRect(bounds.getX() + 4, peakY - 1.0f, (float) meterWidth, 2.0f);
     
-    // LED top-right corner
+    // LED top-right corner: red while the gate is open, orange while "last mic on" holds it
     int ledSize = 12;
     juce::Rectangle<float> ledRect (bounds.getRight() - (ledSize + 6), bounds.getY() + 6, (float) ledSize, (float) ledSize);
-    g.setColour(voiceActive ? juce::Colours::red : juce::Colours::grey);
+    g.setColour(lastMic ? juce::Colours::orange : voiceActive ? juce::Colours::red : juce::Colours::grey);
     g.fillEllipse(ledRect);
     
     // Channel label at top center
@@ -85,8 +90,20 @@ void ChannelStripComponent::setRMSLevel(float level)
     repaint();
 }
 
+void ChannelStripComponent::setPeakLevel(float level)
+{
+    peakLevel = level;
+    repaint();
+}
+
 void ChannelStripComponent::setVoiceActive(bool active)
 {
     voiceActive = active;
     repaint();
 }
+
+void ChannelStripComponent::setLastMic(bool held)
+{
+    lastMic = held;
+    repaint();
+}
@@ -12,7 +12,9 @@ public:
     void resized() override;
     
     void setRMSLevel(float level);
-    void setVoiceActive(bool active);
+    void setPeakLevel(float level);
+    void setVoiceActive(bool active);   // gate open
+    void setLastMic(bool held);         // gate held open by "last mic on"
     
 private:
     juce::AudioProcessorValueTreeState& parameters;
@@ -29,7 +31,9 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> soloAttachment;
     
     float rmsLevel = 0.0f;
+    float peakLevel = 0.0f;
     bool voiceActive = false;
+    bool lastMic = false;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChannelStripComponent)
 };
@@ -0,0 +1,300 @@
+// CrossTalkSuppressor.cpp
+#include "CrossTalkSuppressor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if __has_include(<JuceHeader.h>)
+ #include <JuceHeader.h>
+#endif
+
+// forward(): kFftSize real samples in data[0, kFftSize) become bins 0 .. kFftSize / 2
+// as interleaved re/im. data holds 2 * kFftSize floats.
+#if JUCE_MODULE_AVAILABLE_juce_dsp
+struct CrossTalkSuppressor::Fft
+{
+    void forward(float* data) { fft.performRealOnlyForwardTransform(data, true); }
+
+    juce::dsp::FFT fft { kFftOrder };
+};
+#else
+// Host-free builds (the benchmarks): the real input packed as kFftSize / 2 complex
+// values, an in-place radix-2 FFT on those, and the usual split into the real
+// spectrum. Plain float arithmetic; std::complex multiplies go through a
+// NaN-checking library call unless built with -ffast-math.
+struct CrossTalkSuppressor::Fft
+{
+    static constexpr int kHalf = kFftSize / 2;
+
+    Fft()
+    {
+        for (int i = 0; i < kHalf; ++i)
+        {
+            int reversed = 0;
+            for (int b = 0; b < kFftOrder - 1; ++b)
+                reversed |= ((i >> b) & 1) << (kFftOrder - 2 - b);
+            bitReverse[i] = reversed;
+        }
+        for (int i = 0; i < kHalf; ++i)
+        {
+            cosTable[i] = std::cos(6.28318530718f * static_cast<float>(i) / kFftSize);
+            sinTable[i] = -std::sin(6.28318530718f * static_cast<float>(i) / kFftSize);
+        }
+    }
+
+    void forward(float* data)
+    {
+        // z[n] = x[2n] + i x[2n + 1] is already interleaved complex.
+        for (int i = 0; i < kHalf; ++i)
+        {
+            const int j = bitReverse[i];
+            if (i < j)
+            {
+                std::swap(data[2 * i], data[2 * j]);
+                std::swap(data[2 * i + 1], data[2 * j + 1]);
+            }
+        }
+
+        for (int half = 1; half < kHalf; half *= 2)
+        {
+            const int step = kFftSize / (2 * half); // twiddles of the half-size FFT
+            for (int start = 0; start < kHalf; start += 2 * half)
+                for (int j = 0; j < half; ++j)
+                {
+                    const float wr = cosTable[j * step], wi = sinTable[j * step];
+                    float* a = data + 2 * (start + j);
+                    float* b = data + 2 * (start + j + half);
+                    const float tr = wr * b[0] - wi * b[1];
+                    const float ti = wr * b[1] + wi * b[0];
+                    b[0] = a[0] - tr;
+                    b[1] = a[1] - ti;
+                    a[0] += tr;
+                    a[1] += ti;
+                }
+        }
+
+        // Split: with E = (Z[k] + conj Z[H - k]) / 2 and O = (Z[k] - conj Z[H - k]) / 2i,
+        // X[k] = E + W^k O and X[H - k] = conj(E - W^k O).
+        const float z0r = data[0], z0i = data[1];
+        data[0] = z0r + z0i;
+        data[1] = 0.f;
+        data[2 * kHalf] = z0r - z0i;
+        data[2 * kHalf + 1] = 0.f;
+        for (int k = 1; k <= kHalf / 2; ++k)
+        {
+            float* p = data + 2 * k;
+            float* q = data + 2 * (kHalf - k);
+            const float er = 0.5f * (p[0] + q[0]), ei = 0.5f * (p[1] - q[1]);
+            const float or_ = 0.5f * (p[1] + q[1]), oi = -0.5f * (p[0] - q[0]);
+            const float wr = cosTable[k], wi = sinTable[k];
+            const float tr = wr * or_ - wi * oi, ti = wr * oi + wi * or_;
+            p[0] = er + tr;
+            p[1] = ei + ti;
+            q[0] = er - tr;
+            q[1] = -(ei - ti);
+        }
+    }
+
+    int bitReverse[kHalf];
+    float cosTable[kHalf], sinTable[kHalf];
+};
+#endif
+
+CrossTalkSuppressor::CrossTalkSuppressor() : fft(std::make_unique<Fft>()) {}
+
+CrossTalkSuppressor::~CrossTalkSuppressor() = default;
+
+void CrossTalkSuppressor::prepare(double sampleRate, int numChannels)
+{
+    numChans = std::max(0, numChannels);
+    decimation = std::max(1, static_cast<int>(std::lround(sampleRate / kAnalysisRate)));
+
+    const double analysisRate = sampleRate / decimation;
+    const double binHz = analysisRate / kFftSize;
+    lowBin = std::max(1, static_cast<int>(std::ceil(kLowHz / binHz)));
+    const int highBin = std::min(kFftSize / 2, static_cast<int>(std::floor(kHighHz / binHz)));
+    numBins = std::max(0, highBin - lowBin + 1);
+    holdHops = std::max(1, static_cast<int>(std::ceil(kHoldMs / 1000.0 * analysisRate / kHopSize)));
+
+    window.resize(kFftSize);
+    for (int i = 0; i < kFftSize; ++i)
+        window[static_cast<size_t>(i)] = 0.5f - 0.5f * std::cos(6.28318530718f * static_cast<float>(i) / kFftSize);
+
+    // Band power (sum of |X|^2 over the positive bins) of a signal at kMinReferenceDb RMS,
+    // by Parseval: rms^2 * N * sum(w^2) / 2.
+    float windowPower = 0.f;
+    for (float w : window)
+        windowPower += w * w;
+    minReferencePower = std::pow(10.f, kMinReferenceDb / 10.f) * kFftSize * windowPower / 2.f;
+
+    const auto n = static_cast<size_t>(numChans);
+    const auto bins = static_cast<size_t>(numBins);
+    history.assign(n * kFftSize, 0.f);
+    autoSpectrum.assign(n * bins, 0.f);
+    crossRe.assign(n * bins, 0.f);
+    crossIm.assign(n * bins, 0.f);
+    spectra.assign(n * bins * 2, 0.f);
+    bandPower.assign(n, 0.f);
+    decimatorSum.assign(n, 0.f);
+    holdCount.assign(n, 0);
+    bleed.assign(n, 0);
+    fftBuffer.assign(2 * kFftSize, 0.f);
+    reset();
+}
+
+void CrossTalkSuppressor::reset()
+{
+    std::fill(history.begin(), history.end(), 0.f);
+    std::fill(autoSpectrum.begin(), autoSpectrum.end(), 0.f);
+    std::fill(crossRe.begin(), crossRe.end(), 0.f);
+    std::fill(crossIm.begin(), crossIm.end(), 0.f);
+    std::fill(decimatorSum.begin(), decimatorSum.end(), 0.f);
+    std::fill(holdCount.begin(), holdCount.end(), 0);
+    std::fill(bleed.begin(), bleed.end(), std::uint8_t(0));
+    decimatorPhase = 0;
+    hopFill = 0;
+    reference = -1;
+    hopsSinceSwitch = 0;
+}
+
+void CrossTalkSuppressor::process(const float* const* data, int offset, int numSamples)
+{
+    if (numChans == 0 || numBins == 0)
+        return;
+
+    const float invDecimation = 1.f / static_cast<float>(decimation);
+    for (int pos = 0; pos < numSamples;)
+    {
+        // Up to the end of the current hop:
+        const int toHopEnd = (kHopSize - hopFill) * decimation - decimatorPhase;
+        const int len = std::min(numSamples - pos, toHopEnd);
+
+        // Box-car decimation into the newer half of each history. It aliases, but
+        // identically on every mic, so the coherence between them survives.
+        for (int ch = 0; ch < numChans; ++ch)
+        {
+            const float* x = data[ch] + offset + pos;
+            float* out = history.data() + static_cast<size_t>(ch) * kFftSize + kHopSize;
+            float sum = decimatorSum[static_cast<size_t>(ch)];
+            int fill = hopFill, i = 0;
+
+            // Finish the group left open by the previous call, then whole groups, then
+            // start the next one:
+            if (decimatorPhase > 0)
+            {
+                const int head = std::min(len, decimation - decimatorPhase);
+                for (; i < head; ++i)
+                    sum += x[i];
+                if (decimatorPhase + head == decimation)
+                {
+                    out[fill++] = sum * invDecimation;
+                    sum = 0.f;
+                }
+            }
+            for (; i + decimation <= len; i += decimation)
+            {
+                float group = 0.f;
+                for (int j = 0; j < decimation; ++j)
+                    group += x[i + j];
+                out[fill++] = group * invDecimation;
+            }
+            for (; i < len; ++i)
+                sum += x[i];
+            decimatorSum[static_cast<size_t>(ch)] = sum;
+        }
+
+        const int total = decimatorPhase + len;
+        hopFill += total / decimation;
+        decimatorPhase = total % decimation;
+        pos += len;
+
+        if (hopFill == kHopSize)
+        {
+            analyseHop();
+            hopFill = 0;
+        }
+    }
+}
+
+void CrossTalkSuppressor::analyseHop()
+{
+    const auto bins = static_cast<size_t>(numBins);
+    const float a = kSpectrumSmoothing, b = 1.f - kSpectrumSmoothing;
+
+    // One FFT per channel; smoothed auto spectra and band power:
+    for (int ch = 0; ch < numChans; ++ch)
+    {
+        float* h = history.data() + static_cast<size_t>(ch) * kFftSize;
+        for (int i = 0; i < kFftSize; ++i)
+            fftBuffer[static_cast<size_t>(i)] = h[i] * window[static_cast<size_t>(i)];
+        fft->forward(fftBuffer.data());
+        std::memmove(h, h + kHopSize, sizeof(float) * kHopSize);
+
+        float* spectrum = spectra.data() + static_cast<size_t>(ch) * bins * 2;
+        std::memcpy(spectrum, fftBuffer.data() + 2 * lowBin, sizeof(float) * bins * 2);
+
+        float* s = autoSpectrum.data() + static_cast<size_t>(ch) * bins;
+        float power = 0.f;
+        for (size_t k = 0; k < bins; ++k)
+        {
+            const float re = spectrum[2 * k], im = spectrum[2 * k + 1];
+            s[k] = a * s[k] + b * (re * re + im * im);
+            power += s[k];
+        }
+        bandPower[static_cast<size_t>(ch)] = power;
+    }
+
+    // The reference moves to a louder mic only by a margin; its cross spectra restart.
+    const int loudest = static_cast<int>(std::max_element(bandPower.begin(), bandPower.end()) - bandPower.begin());
+    const float switchRatio = std::pow(10.f, kReferenceSwitchDb / 10.f);
+    if (reference < 0 || bandPower[static_cast<size_t>(loudest)] > switchRatio * bandPower[static_cast<size_t>(reference)])
+    {
+        if (loudest != reference)
+        {
+            reference = loudest;
+            hopsSinceSwitch = 0;
+            std::fill(crossRe.begin(), crossRe.end(), 0.f);
+            std::fill(crossIm.begin(), crossIm.end(), 0.f);
+        }
+    }
+    ++hopsSinceSwitch;
+
+    const auto r = static_cast<size_t>(reference);
+    const float* refSpectrum = spectra.data() + r * bins * 2;
+    const float* refAuto = autoSpectrum.data() + r * bins;
+    const float refPower = bandPower[r];
+    const float levelRatio = std::pow(10.f, -kMinLevelDifferenceDb / 10.f);
+    const bool judging = refPower > minReferencePower && hopsSinceSwitch >= kMinHopsAfterSwitch;
+
+    // Each mic against the reference only: linear in the channel count.
+    for (int ch = 0; ch < numChans; ++ch)
+    {
+        const auto c = static_cast<size_t>(ch);
+        bool isBleed = false;
+        if (ch != reference)
+        {
+            const float* spectrum = spectra.data() + c * bins * 2;
+            const float* s = autoSpectrum.data() + c * bins;
+            float* cr = crossRe.data() + c * bins;
+            float* ci = crossIm.data() + c * bins;
+            float crossPower = 0.f, autoProduct = 0.f;
+            for (size_t k = 0; k < bins; ++k)
+            {
+                const float xr = spectrum[2 * k], xi = spectrum[2 * k + 1];
+                const float rr = refSpectrum[2 * k], ri = refSpectrum[2 * k + 1];
+                cr[k] = a * cr[k] + b * (xr * rr + xi * ri);
+                ci[k] = a * ci[k] + b * (xi * rr - xr * ri);
+                crossPower += cr[k] * cr[k] + ci[k] * ci[k];
+                autoProduct += s[k] * refAuto[k];
+            }
+
+            // Coherence over the band, weighted towards its strongest bins:
+            const float coherence = crossPower / (autoProduct + 1e-30f);
+            isBleed = judging & (coherence > kMinCoherence) & (bandPower[c] < levelRatio * refPower);
+        }
+
+        int& hold = holdCount[c];
+        hold = isBleed ? holdHops : std::max(0, hold - 1);
+        bleed[c] = hold > 0 ? 1 : 0;
+    }
+}
@@ -0,0 +1,90 @@
+// CrossTalkSuppressor.h
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+    CrossTalkSuppressor:
+    - Finds mics that only carry bleed from a talker on another mic, so the
+      engine can keep their gates shut. One talker in a panel room otherwise
+      opens every mic near them.
+    - Works on detector signals decimated to about kAnalysisRate. Every hop
+      each channel gets one windowed FFT (juce::dsp::FFT in the plugin; a small
+      built-in radix-2 FFT where JUCE isn't available, e.g. the benchmarks).
+    - Every mic is compared only against the reference: the loudest mic over
+      the speech band. A mic is bleed when its spectrum is coherent with the
+      reference (magnitude-squared coherence from time-averaged cross spectra)
+      and it is at least kMinLevelDifferenceDb quieter. Coherence is insensitive
+      to the few ms of delay between mics. A second talker on their own mic is
+      not coherent with the first and stays open.
+    - One FFT and one cross spectrum per channel per hop, so the cost grows
+      linearly with the channel count; no mic pairs are enumerated.
+    - A bleed decision is held for kHoldMs so gates don't chatter.
+    - prepare() allocates; process() doesn't.
+*/
+class CrossTalkSuppressor
+{
+public:
+    static constexpr double kAnalysisRate = 12000.0;
+    static constexpr int kFftOrder = 8;
+    static constexpr int kFftSize = 1 << kFftOrder;   // 21 ms at kAnalysisRate
+    static constexpr int kHopSize = kFftSize / 2;
+    static constexpr float kLowHz = 200.f, kHighHz = 4000.f;
+
+    static constexpr float kMinCoherence = 0.6f;
+    static constexpr float kMinLevelDifferenceDb = 6.f;
+    static constexpr float kMinReferenceDb = -60.f;    // RMS of the reference over the band
+    static constexpr float kReferenceSwitchDb = 2.f;   // hysteresis before the reference moves
+    static constexpr float kSpectrumSmoothing = 0.7f;  // per hop
+    static constexpr int kMinHopsAfterSwitch = 4;
+    static constexpr float kHoldMs = 100.f;
+
+    CrossTalkSuppressor();
+    ~CrossTalkSuppressor();
+
+    // Message thread.
+    void prepare(double sampleRate, int numChannels);
+    void reset();
+
+    // Audio thread. Feeds samples [offset, offset + numSamples) of every channel and
+    // analyses each hop as it completes.
+    void process(const float* const* data, int offset, int numSamples);
+
+    // 1 for each channel currently judged to carry only bleed, numChannels entries.
+    const std::uint8_t* getBleedMask() const { return bleed.data(); }
+
+    // The current reference (loudest) channel, or -1 before the first hop.
+    int getReferenceChannel() const { return reference; }
+
+private:
+    struct Fft;
+
+    void analyseHop();
+
+    std::unique_ptr<Fft> fft;
+    int numChans = 0;
+    int decimation = 1;
+    int lowBin = 0, numBins = 0;
+    int holdHops = 1;
+    float minReferencePower = 0.f;
+
+    std::vector<float> window;
+
+    // Per channel, numChans x stride:
+    std::vector<float> history;        // last kFftSize decimated samples
+    std::vector<float> autoSpectrum;   // smoothed |X|^2, numBins per channel
+    std::vector<float> crossRe, crossIm; // smoothed X * conj(X_reference)
+    std::vector<float> spectra;        // this hop's bins, interleaved re/im
+    std::vector<float> bandPower;      // sum of autoSpectrum, one per channel
+    std::vector<float> decimatorSum;
+    std::vector<int> holdCount;
+    std::vector<std::uint8_t> bleed;
+
+    std::vector<float> fftBuffer;      // 2 * kFftSize
+    int decimatorPhase = 0;
+    int hopFill = 0;
+    int reference = -1;
+    int hopsSinceSwitch = 0;
+};
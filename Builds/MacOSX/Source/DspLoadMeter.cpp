@@ -0,0 +1,73 @@
+// DspLoadMeter.cpp
+#include "DspLoadMeter.h"
+
+#include <algorithm>
+
+void DspLoadMeter::prepare(double sampleRate)
+{
+    secondsPerSample.store(sampleRate > 0.0 ? 1.0 / sampleRate : 1.0 / 44100.0, std::memory_order_relaxed);
+    reset();
+}
+
+void DspLoadMeter::addBlock(int numSamples, Clock::duration elapsed) noexcept
+{
+    if (resetRequested.load(std::memory_order_relaxed))
+    {
+        resetRequested.store(false, std::memory_order_relaxed);
+        for (auto& bin : bins)
+            bin.store(0, std::memory_order_relaxed);
+        blocks.store(0, std::memory_order_relaxed);
+        overruns.store(0, std::memory_order_relaxed);
+        maxLoad.store(0.f, std::memory_order_relaxed);
+    }
+
+    if (numSamples <= 0)
+        return;
+
+    const double deadline = numSamples * secondsPerSample.load(std::memory_order_relaxed);
+    const float load = static_cast<float>(std::chrono::duration<double>(elapsed).count() / deadline);
+
+    const int bin = std::min(static_cast<int>(load * kBinsPerDeadline), kNumBins - 1);
+    increment(bins[static_cast<size_t>(bin)]);
+    increment(blocks);
+    if (load > 1.f)
+        increment(overruns);
+    if (load > maxLoad.load(std::memory_order_relaxed))
+        maxLoad.store(load, std::memory_order_relaxed);
+}
+
+DspLoadMeter::Stats DspLoadMeter::getStats() const
+{
+    std::array<std::uint64_t, kNumBins> counts;
+    std::uint64_t total = 0;
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        counts[i] = bins[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    Stats s;
+    s.blocks = blocks.load(std::memory_order_relaxed);
+    s.overruns = overruns.load(std::memory_order_relaxed);
+    s.max = maxLoad.load(std::memory_order_relaxed);
+    if (total == 0)
+        return s;
+
+    // Upper edge of the bin holding the given rank; the open-ended last bin reports the max.
+    auto percentile = [&](double p)
+    {
+        const auto rank = static_cast<std::uint64_t>(p * static_cast<double>(total - 1));
+        std::uint64_t seen = 0;
+        for (int i = 0; i < kNumBins - 1; ++i)
+        {
+            seen += counts[static_cast<size_t>(i)];
+            if (seen > rank)
+                return std::min(static_cast<float>(i + 1) / kBinsPerDeadline, s.max);
+        }
+        return s.max;
+    };
+
+    s.p50 = percentile(0.5);
+    s.p99 = percentile(0.99);
+    return s;
+}
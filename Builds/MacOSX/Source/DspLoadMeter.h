@@ -0,0 +1,81 @@
+// DspLoadMeter.h
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+    DspLoadMeter:
+    - Times each audio callback against its deadline (the block's duration in
+      real time) and keeps a histogram of that load, the worst block and the
+      number of overruns (load above 1, i.e. the callback alone took longer
+      than the audio it produced).
+    - The audio thread is the only writer. Every field is a relaxed atomic it
+      updates with plain load/store, so timing a block costs two clock reads
+      and a few stores: no locks, no read-modify-write.
+    - Any other thread may call getStats() at any time. It reads the bins
+      without stopping the writer, so a snapshot can be a block or two
+      inconsistent, which doesn't matter at the resolution of the histogram.
+    - reset() only raises a flag; the audio thread clears the counts before
+      its next block.
+*/
+class DspLoadMeter
+{
+public:
+    static constexpr int kBinsPerDeadline = 64;       // 1/64 of the deadline per bin
+    static constexpr int kNumBins = 2 * kBinsPerDeadline + 1; // up to 2x, last bin is everything above
+
+    struct Stats
+    {
+        std::uint64_t blocks = 0;
+        std::uint64_t overruns = 0;
+        float p50 = 0.f, p99 = 0.f; // fraction of the deadline, upper edge of the bin
+        float max = 0.f;            // exact
+    };
+
+    // Message thread, before processing starts.
+    void prepare(double sampleRate);
+
+    // Any thread.
+    void reset() { resetRequested.store(true, std::memory_order_relaxed); }
+    Stats getStats() const;
+
+    // Audio thread. Times the callback it lives in.
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock(DspLoadMeter& m, int numSamples) noexcept
+            : meter(m), samples(numSamples), start(Clock::now()) {}
+        ~ScopedBlock() noexcept { meter.addBlock(samples, Clock::now() - start); }
+
+        ScopedBlock(const ScopedBlock&) = delete;
+        ScopedBlock& operator=(const ScopedBlock&) = delete;
+
+    private:
+        DspLoadMeter& meter;
+        int samples;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // Audio thread. Records one callback that took elapsed for numSamples samples.
+    void addBlock(int numSamples, std::chrono::steady_clock::duration elapsed) noexcept;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    template <typename T>
+    static void increment(std::atomic<T>& a) noexcept
+    {
+        a.store(a.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::atomic<double> secondsPerSample { 1.0 / 44100.0 };
+    std::atomic<bool> resetRequested { false };
+
+    std::array<std::atomic<std::uint64_t>, kNumBins> bins {};
+    std::atomic<std::uint64_t> blocks { 0 };
+    std::atomic<std::uint64_t> overruns { 0 };
+    std::atomic<float> maxLoad { 0.f };
+};
@@ -0,0 +1,247 @@
+// DspVoiceActivityDetector.cpp
+#include "DspVoiceActivityDetector.h"
+#include "FastMath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+ #define MDP_VAD_SSE 1
+ #include <immintrin.h>
+#else
+ #define MDP_VAD_SSE 0
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+ #define MDP_VAD_NEON 1
+ #include <arm_neon.h>
+#else
+ #define MDP_VAD_NEON 0
+#endif
+
+namespace
+{
+    // Band centres (Hz), roughly log-spaced over the range a talker occupies.
+    constexpr float kBandCentres[DspVoiceActivityDetector::kNumBands] = { 150.f, 300.f, 500.f, 850.f,
+                                                                          1400.f, 2300.f, 3800.f, 6000.f };
+    constexpr float kBandQ = 1.4f;
+    constexpr float kSpeechLowHz = 250.f, kSpeechHighHz = 4000.f;
+
+    // Decision thresholds, tuned on the synthetic corpus in mdp_vad_bench.
+    constexpr float kMinSnrDb = 6.f;
+    constexpr float kMinLevelDb = -65.f;
+    constexpr float kMinBandRatio = 0.35f;
+    constexpr float kMinFlux = 1.5f;
+    constexpr float kMaxZeroCrossingRate = 0.25f;
+    constexpr float kFluxSmoothing = 0.5f;        // per frame
+    constexpr float kFloorRiseDbPerSecond = 3.f;
+    constexpr float kFloorFallSmoothing = 0.5f;   // per frame, towards a quieter frame
+    constexpr float kHangoverSeconds = 0.2f;
+
+    constexpr int kNumBands = DspVoiceActivityDetector::kNumBands;
+
+    // All bands advance together, two vectors of four bands per sample. Transposed
+    // direct form II bandpass, so b1 = 0 and b2 = -b0. The compilers won't vectorise
+    // this across bands on their own (the recurrences get split into scalars), hence
+    // the explicit SSE/NEON versions.
+    static_assert(kNumBands == 8, "filterBank() is written for two vectors of four bands");
+
+#if MDP_VAD_SSE
+    void filterBank(const float* x, int n, const float* b0, const float* a1, const float* a2,
+                    float* s1, float* s2, float* energy)
+    {
+        const __m128 b0Lo = _mm_loadu_ps(b0), b0Hi = _mm_loadu_ps(b0 + 4);
+        const __m128 a1Lo = _mm_loadu_ps(a1), a1Hi = _mm_loadu_ps(a1 + 4);
+        const __m128 a2Lo = _mm_loadu_ps(a2), a2Hi = _mm_loadu_ps(a2 + 4);
+        __m128 z1Lo = _mm_loadu_ps(s1), z1Hi = _mm_loadu_ps(s1 + 4);
+        __m128 z2Lo = _mm_loadu_ps(s2), z2Hi = _mm_loadu_ps(s2 + 4);
+        __m128 eLo = _mm_setzero_ps(), eHi = _mm_setzero_ps();
+
+        for (int i = 0; i < n; ++i)
+        {
+            const __m128 xi = _mm_set1_ps(x[i]);
+            const __m128 bxLo = _mm_mul_ps(b0Lo, xi), bxHi = _mm_mul_ps(b0Hi, xi);
+            const __m128 yLo = _mm_add_ps(bxLo, z1Lo), yHi = _mm_add_ps(bxHi, z1Hi);
+            z1Lo = _mm_sub_ps(z2Lo, _mm_mul_ps(a1Lo, yLo));
+            z1Hi = _mm_sub_ps(z2Hi, _mm_mul_ps(a1Hi, yHi));
+            z2Lo = _mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(bxLo, _mm_mul_ps(a2Lo, yLo)));
+            z2Hi = _mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(bxHi, _mm_mul_ps(a2Hi, yHi)));
+            eLo = _mm_add_ps(eLo, _mm_mul_ps(yLo, yLo));
+            eHi = _mm_add_ps(eHi, _mm_mul_ps(yHi, yHi));
+        }
+
+        _mm_storeu_ps(s1, z1Lo); _mm_storeu_ps(s1 + 4, z1Hi);
+        _mm_storeu_ps(s2, z2Lo); _mm_storeu_ps(s2 + 4, z2Hi);
+        _mm_storeu_ps(energy, eLo); _mm_storeu_ps(energy + 4, eHi);
+    }
+#elif MDP_VAD_NEON
+    void filterBank(const float* x, int n, const float* b0, const float* a1, const float* a2,
+                    float* s1, float* s2, float* energy)
+    {
+        const float32x4_t b0Lo = vld1q_f32(b0), b0Hi = vld1q_f32(b0 + 4);
+        const float32x4_t a1Lo = vld1q_f32(a1), a1Hi = vld1q_f32(a1 + 4);
+        const float32x4_t a2Lo = vld1q_f32(a2), a2Hi = vld1q_f32(a2 + 4);
+        float32x4_t z1Lo = vld1q_f32(s1), z1Hi = vld1q_f32(s1 + 4);
+        float32x4_t z2Lo = vld1q_f32(s2), z2Hi = vld1q_f32(s2 + 4);
+        float32x4_t eLo = vdupq_n_f32(0.f), eHi = vdupq_n_f32(0.f);
+
+        for (int i = 0; i < n; ++i)
+        {
+            const float xi = x[i];
+            const float32x4_t bxLo = vmulq_n_f32(b0Lo, xi), bxHi = vmulq_n_f32(b0Hi, xi);
+            const float32x4_t yLo = vaddq_f32(bxLo, z1Lo), yHi = vaddq_f32(bxHi, z1Hi);
+            z1Lo = vfmsq_f32(z2Lo, a1Lo, yLo);
+            z1Hi = vfmsq_f32(z2Hi, a1Hi, yHi);
+            z2Lo = vnegq_f32(vfmaq_f32(bxLo, a2Lo, yLo));
+            z2Hi = vnegq_f32(vfmaq_f32(bxHi, a2Hi, yHi));
+            eLo = vfmaq_f32(eLo, yLo, yLo);
+            eHi = vfmaq_f32(eHi, yHi, yHi);
+        }
+
+        vst1q_f32(s1, z1Lo); vst1q_f32(s1 + 4, z1Hi);
+        vst1q_f32(s2, z2Lo); vst1q_f32(s2 + 4, z2Hi);
+        vst1q_f32(energy, eLo); vst1q_f32(energy + 4, eHi);
+    }
+#else
+    void filterBank(const float* x, int n, const float* b0, const float* a1, const float* a2,
+                    float* s1, float* s2, float* energy)
+    {
+        for (int b = 0; b < kNumBands; ++b)
+        {
+            float z1 = s1[b], z2 = s2[b], e = 0.f;
+            for (int i = 0; i < n; ++i)
+            {
+                const float bx = b0[b] * x[i];
+                const float y = bx + z1;
+                z1 = z2 - a1[b] * y;
+                z2 = -(bx + a2[b] * y);
+                e += y * y;
+            }
+            s1[b] = z1;
+            s2[b] = z2;
+            energy[b] = e;
+        }
+    }
+#endif
+
+    // Sum of squares and sign changes in one branch-free pass.
+    void energyAndCrossings(const float* __restrict x, int n, float& energy, int& crossings)
+    {
+        float sum = 0.f;
+        int count = 0;
+        std::uint32_t previousSign = FastMath::floatToBits(x[0]) >> 31;
+        for (int i = 0; i < n; ++i)
+        {
+            const std::uint32_t sign = FastMath::floatToBits(x[i]) >> 31;
+            count += static_cast<int>(sign ^ previousSign);
+            previousSign = sign;
+            sum += x[i] * x[i];
+        }
+        energy = sum;
+        crossings = count;
+    }
+}
+
+DspVoiceActivityDetector::DspVoiceActivityDetector(double rate, int numChannels)
+    : sampleRate(rate > 0.0 ? rate : 48000.0),
+      hangoverSamples(static_cast<int>(kHangoverSeconds * sampleRate)),
+      channels(static_cast<size_t>(std::max(0, numChannels)))
+{
+    firstSpeechBand = kNumBands;
+    lastSpeechBand = -1;
+    for (int b = 0; b < kNumBands; ++b)
+    {
+        // RBJ bandpass, 0 dB peak. A band too close to Nyquist for this rate stays silent.
+        const double f = std::min(static_cast<double>(kBandCentres[b]), 0.4 * sampleRate);
+        const double w0 = 2.0 * 3.14159265358979 * f / sampleRate;
+        const double alpha = std::sin(w0) / (2.0 * kBandQ);
+        const double a0 = 1.0 + alpha;
+        bank.b0[b] = kBandCentres[b] < 0.4 * sampleRate ? static_cast<float>(alpha / a0) : 0.f;
+        bank.a1[b] = static_cast<float>(-2.0 * std::cos(w0) / a0);
+        bank.a2[b] = static_cast<float>((1.0 - alpha) / a0);
+
+        if (kBandCentres[b] >= kSpeechLowHz && kBandCentres[b] <= kSpeechHighHz)
+        {
+            firstSpeechBand = std::min(firstSpeechBand, b);
+            lastSpeechBand = std::max(lastSpeechBand, b);
+        }
+    }
+}
+
+bool DspVoiceActivityDetector::detectSpeech(const float* samples, int numSamples, int channelIndex)
+{
+    return analyse(samples, numSamples, channelIndex) > kSpeechThreshold;
+}
+
+void DspVoiceActivityDetector::detectSpeechBatch(const float* const* frames, int numChannels, int numSamples,
+                                                 float* probabilities)
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+        probabilities[ch] = analyse(frames[ch], numSamples, ch);
+}
+
+float DspVoiceActivityDetector::analyse(const float* samples, int numSamples, int channelIndex)
+{
+    if (channelIndex < 0 || channelIndex >= static_cast<int>(channels.size()) || numSamples <= 0)
+        return 0.f;
+
+    ChannelState& st = channels[static_cast<size_t>(channelIndex)];
+    Features& f = st.features;
+
+    alignas(32) float bandEnergy[kNumBands];
+    filterBank(samples, numSamples, bank.b0, bank.a1, bank.a2, st.s1, st.s2, bandEnergy);
+
+    float energy = 0.f;
+    int crossings = 0;
+    energyAndCrossings(samples, numSamples, energy, crossings);
+
+    const float invN = 1.f / static_cast<float>(numSamples);
+    f.energyDb = FastMath::linearToDb(std::sqrt(energy * invN));
+    f.zeroCrossingRate = static_cast<float>(crossings) * invN;
+
+    // Band ratio and flux on log band energies:
+    float speechEnergy = 0.f, flux = 0.f;
+    for (int b = 0; b < kNumBands; ++b)
+    {
+        const float e = bandEnergy[b];
+        speechEnergy += (b >= firstSpeechBand && b <= lastSpeechBand) ? e : 0.f;
+
+        const float logE = FastMath::linearToDb(std::sqrt(e * invN));
+        flux += std::max(0.f, logE - st.previousLog[b]);
+        st.previousLog[b] = logE;
+    }
+    f.bandRatio = speechEnergy / (energy + 1e-20f);
+    flux *= 1.f / static_cast<float>(kNumBands);
+
+    const float frameSeconds = static_cast<float>(numSamples / sampleRate);
+    if (!st.primed)
+    {
+        // First frame: no previous spectrum, and the floor starts at this frame's level.
+        st.noiseFloorDb = f.energyDb;
+        st.fluxAverage = 0.f;
+        st.primed = true;
+        flux = 0.f;
+    }
+    st.fluxAverage += kFluxSmoothing * (flux - st.fluxAverage);
+    f.flux = st.fluxAverage;
+
+    // Noise floor: follows quieter frames quickly, rises only slowly.
+    if (f.energyDb < st.noiseFloorDb)
+        st.noiseFloorDb += kFloorFallSmoothing * (f.energyDb - st.noiseFloorDb);
+    else
+        st.noiseFloorDb += std::min(f.energyDb - st.noiseFloorDb, kFloorRiseDbPerSecond * frameSeconds);
+    f.noiseFloorDb = st.noiseFloorDb;
+
+    const bool loudEnough = (f.energyDb > kMinLevelDb) & (f.energyDb - st.noiseFloorDb > kMinSnrDb);
+    const bool speechLike = (f.bandRatio > kMinBandRatio) & (f.zeroCrossingRate < kMaxZeroCrossingRate);
+    const bool active = loudEnough & speechLike & ((f.flux > kMinFlux) | (st.hangover > 0));
+
+    if (active)
+        st.hangover = hangoverSamples;
+    else
+        st.hangover = std::max(0, st.hangover - numSamples);
+
+    if (active)
+        return 1.f;
+    return st.hangover > 0 ? 0.5f + 0.5f * static_cast<float>(st.hangover) / static_cast<float>(hangoverSamples) : 0.f;
+}
@@ -0,0 +1,82 @@
+// DspVoiceActivityDetector.h
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "MLSpeechDetector.h"
+
+/**
+    DspVoiceActivityDetector:
+    - A built-in MLSpeechDetector for machines that can't afford neural
+      inference on every channel. A few microseconds per channel per frame.
+    - Features per frame:
+        band ratio   energy in the speech bands (~300 Hz to 3.8 kHz) over total energy
+        flux         rise in log band energies against the previous frame,
+                     averaged over a few frames: speech changes every syllable,
+                     hum, fans and sustained music don't
+        zero-crossing rate, which rejects broadband hiss
+        SNR          frame energy above a slowly rising noise-floor tracker
+    - The band energies come from kNumBands bandpass biquads run side by side:
+      each sample updates every band at once in two SSE/NEON vectors (scalar
+      elsewhere). ZCR and energy are one branch-free pass.
+    - About 3 us per channel per 10 ms frame; accuracy on a synthetic
+      speech/noise corpus is in mdp_vad_bench.
+    - A hangover keeps a channel active through the short gaps between words.
+    - The batch form is a plain loop over channels without the per-channel
+      virtual call; the work itself is per channel anyway.
+    - Per-channel state (filter memory, noise floor, previous spectrum) is
+      allocated in the constructor; detectSpeech() never allocates. Channels
+      outside [0, numChannels) report no speech.
+*/
+class DspVoiceActivityDetector : public MLSpeechDetector
+{
+public:
+    static constexpr int kNumBands = 8;
+
+    DspVoiceActivityDetector(double sampleRate, int numChannels);
+
+    bool detectSpeech(const float* samples, int numSamples, int channelIndex) override;
+
+    // 1 while speech is detected, fading from 1 towards 0.5 over the hangover, then 0.
+    void detectSpeechBatch(const float* const* frames, int numChannels, int numSamples, float* probabilities) override;
+
+    struct Features
+    {
+        float energyDb = -120.f;
+        float noiseFloorDb = -120.f;
+        float bandRatio = 0.f;
+        float flux = 0.f;              // averaged, in dB per band
+        float zeroCrossingRate = 0.f;  // crossings per sample
+    };
+
+    // Features of the last frame seen on channel ch (for tuning and meters).
+    const Features& getLastFeatures(int ch) const { return channels[static_cast<std::size_t>(ch)].features; }
+
+private:
+    struct Bank
+    {
+        alignas(32) float b0[kNumBands];
+        alignas(32) float a1[kNumBands];
+        alignas(32) float a2[kNumBands];
+    };
+
+    struct ChannelState
+    {
+        alignas(32) float s1[kNumBands] {};
+        alignas(32) float s2[kNumBands] {};
+        alignas(32) float previousLog[kNumBands] {};
+        float noiseFloorDb = 0.f;
+        float fluxAverage = 0.f;
+        int hangover = 0;              // samples left
+        bool primed = false;
+        Features features;
+    };
+
+    float analyse(const float* samples, int numSamples, int channelIndex);
+
+    Bank bank;
+    int firstSpeechBand = 0, lastSpeechBand = 0;
+    double sampleRate = 48000.0;
+    int hangoverSamples = 0;
+    std::vector<ChannelState> channels;
+};
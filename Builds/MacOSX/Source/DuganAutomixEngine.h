@@ -0,0 +1,991 @@
+// DuganAutomixEngine.h
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "AudioWorkerPool.h"
+#include "AutomixChannelState.h"
+#include "AutomixParameters.h"
+#include "CrossTalkSuppressor.h"
+#include "FastMath.h"
+#include "LookaheadRing.h"
+#include "MeterFrame.h"
+#include "PlanarScratchBuffer.h"
+#include "RealtimeSafety.h"
+#include "SidechainDetector.h"
+#include "SpeechAnalysisThread.h"
+#include "TripleBuffer.h"
+#include "VectorKernels.h"
+
+//==============================================================================
+// Adaptive-threshold policies. offsetDb() is added to the gate threshold from the
+// sidechain level (RMS of the loudest sidechain channel).
+
+struct NoAdaptiveThreshold
+{
+    static constexpr bool enabled = false;
+    static float offsetDb(float, float) { return 0.f; }
+};
+
+// 0 dB offset at a -40 dBFS sidechain, +influence dB per 40 dB above that.
+struct SidechainOffsetThreshold
+{
+    static constexpr bool enabled = true;
+    static float offsetDb(float influence, float sidechainDb) { return influence * (sidechainDb + 40.f) / 40.f; }
+};
+
+// Half the sidechain level in dB, scaled by influence / 40.
+struct SidechainScaledThreshold
+{
+    static constexpr bool enabled = true;
+    static float offsetDb(float influence, float sidechainDb) { return influence * sidechainDb * 0.5f / 40.f; }
+};
+
+/**
+    DuganAutomixEngine:
+    - Dugan-style gain sharing with attack/release gating, "last mic on" and
+      optional sidechain-driven adaptive thresholds and ducking.
+    - One hot loop for every variant. Features are compile-time policies, so a
+      feature that is compiled out costs no branch per block;
+      its setters still exist but are ignored. Policies must provide:
+
+        static constexpr bool lookahead;            // delay the audio via LookaheadRing
+        static constexpr bool speechGating;         // ML/VAD may hold gates closed
+        static constexpr bool crossTalkSuppression; // CrossTalkSuppressor may hold bleed-only gates closed
+        static constexpr bool leveler;              // link-leveler gain clamp
+        static constexpr bool parallelChannels;     // per-channel phases on AudioWorkerPool
+        static constexpr bool meterMutedChannels;   // muted channels keep updating RMS
+        using AdaptiveThreshold = ...;              // one of the threshold policies above
+
+    - Gating and gain sharing run at a fixed control rate: one decision every
+      controlBlockSize samples of the input stream, whatever the host block size.
+      Each decision is ramped in over the following control block. The phase
+      carries across host blocks, so a host block may end mid control block,
+      and all time constants are per control block.
+    - Per host block: measure every channel (parallel), then make the decisions
+      in order (serial, vectorised across channels), then apply the gain ramps
+      (parallel). The worker pool is dispatched twice per host block, not once
+      per control block.
+    - Lookahead: detection runs on the live input and the gains are applied to
+      the input delayed by the lookahead, so gates open before the audio that
+      opened them. The delay is the plugin's latency (getLatencySamples()). The
+      ring is sized for kMaxLookaheadMs in prepare(), and changing the lookahead
+      live crossfades between the old and new delay without reallocating.
+      Zero-latency mode bypasses the delay entirely.
+    - Sidechain: up to SidechainDetector::kMaxChannels channels, measured per
+      control block. Ducking pulls the whole automix down by duckDepthDb while
+      the sidechain is above duckThresholdDb (e.g. for programme playback).
+    - ML/VAD speech gating (speechGating policy): with a detector set, the live
+      input goes to a SpeechAnalysisThread in kSpeechFrameMs frames, and each
+      block applies whatever per-channel results have come back. A gate may
+      only open on a channel whose latest result is speech.
+    - Setters may be called from any non-audio thread. Each one edits a master
+      AutomixParameters under a mutex and publishes a copy through a TripleBuffer.
+      The audio thread takes the latest snapshot with one acquire load per block.
+      It recomputes coefficients (std::exp, dB conversions, per-channel linear
+      gains) only when the snapshot version changes.
+    - Metering goes the other way: at the end of every processBlock() the audio
+      thread copies RMS, peak, gain, gate and last-mic state into a MeterFrame
+      and publishes it through a second TripleBuffer. The UI reads the newest
+      frame; the audio thread's cost doesn't depend on how often, or by how
+      many editors, it is read.
+    - Output: processBlock() either writes each gained channel back in place, or
+      (the mixing overload) sums the gained channels into a set of output buses
+      through a per-channel output matrix (pan), in the same pass that applies
+      the gains. Each control-block segment of a channel is read once and
+      accumulated into every output it feeds. With the worker pool, each channel
+      range mixes into its own partial bus; the partial buses are summed into
+      the outputs after the barrier, so outputs may alias the inputs.
+    - MyDuganAutomixer and EnhancedDuganAGC are aliases over the two policy sets
+      in their headers, and are explicitly instantiated in their .cpp files.
+*/
+template <typename Policies>
+class DuganAutomixEngine
+{
+public:
+    DuganAutomixEngine() = default;
+    ~DuganAutomixEngine() = default;
+
+    // Prepare for a given sample rate, block size, number of channels, and optional sidechain
+    // count. outputChannels is the bus count for the mixing processBlock() (0 = in place only).
+    void prepare(double sampleRate, int blockSize, int mainChannels, int sideChainCount, int outputChannels = 0);
+
+    // Process audio in place, in real time:
+    void processBlock(float** mainData, int mainCh, int numSamples,
+                      float** sideData, int sideCh, int sideSamples);
+
+    // Process and mix, in real time: outputs (numOutputs must match prepare()) are
+    // overwritten with the gained channels summed through the output matrix. The
+    // outputs may alias mainData, which is used as scratch.
+    void processBlock(float** mainData, int mainCh, int numSamples,
+                      float** sideData, int sideCh, int sideSamples,
+                      float** outputs, int numOutputs);
+
+    // Parameter setters (any thread except the audio thread):
+    void setMasterGain(float g)          { updateParameters([=](AutomixParameters& p) { p.masterGain = g; }); }
+    void setGateThreshold(float dB)      { updateParameters([=](AutomixParameters& p) { p.gateThreshold = dB; }); }
+    void setGateHysteresis(float dB)     { updateParameters([=](AutomixParameters& p) { p.gateHysteresis = dB; }); }
+    void setGateCloseDb(float dB)        { updateParameters([=](AutomixParameters& p) { p.gateCloseDb = dB; }); }
+    void setGateAttackMs(float ms)       { updateParameters([=](AutomixParameters& p) { p.gateAttackMs = ms; }); }
+    void setGateReleaseMs(float ms)      { updateParameters([=](AutomixParameters& p) { p.gateReleaseMs = ms; }); }
+    void setLastMicOn(bool b)            { updateParameters([=](AutomixParameters& p) { p.lastMicOn = b; }); }
+    void setShortTermMs(float ms)        { updateParameters([=](AutomixParameters& p) { p.shortTermMs = ms; }); }
+    void setLongTermMs(float ms)         { updateParameters([=](AutomixParameters& p) { p.longTermMs = ms; }); }
+    void setLinkLeveler(bool b)          { updateParameters([=](AutomixParameters& p) { p.linkLeveler = b; }); }
+    void setLevelerRangeDb(float dB)     { updateParameters([=](AutomixParameters& p) { p.levelerRangeDb = dB; }); }
+    void setUseAdaptiveThreshold(bool b) { updateParameters([=](AutomixParameters& p) { p.useAdaptiveThreshold = b; }); }
+    void setSidechainInfluence(float f)  { updateParameters([=](AutomixParameters& p) { p.sidechainInfluence = f; }); }
+
+    // Sidechain ducking:
+    void setDuckingEnabled(bool b)       { updateParameters([=](AutomixParameters& p) { p.duckingEnabled = b; }); }
+    void setDuckThresholdDb(float dB)    { updateParameters([=](AutomixParameters& p) { p.duckThresholdDb = dB; }); }
+    void setDuckDepthDb(float dB)        { updateParameters([=](AutomixParameters& p) { p.duckDepthDb = dB; }); }
+    void setDuckAttackMs(float ms)       { updateParameters([=](AutomixParameters& p) { p.duckAttackMs = ms; }); }
+    void setDuckReleaseMs(float ms)      { updateParameters([=](AutomixParameters& p) { p.duckReleaseMs = ms; }); }
+
+    // Lookahead, 0 to kMaxLookaheadMs; live changes are crossfaded over kDelayCrossfadeMs.
+    // Zero latency ignores the lookahead (for IFB and other monitoring feeds).
+    static constexpr float kMaxLookaheadMs = 20.f;
+    static constexpr float kDelayCrossfadeMs = 5.f;
+    void setLookaheadMs(float ms)        { updateParameters([=](AutomixParameters& p) { p.lookaheadMs = ms; }); }
+    void setZeroLatency(bool b)          { updateParameters([=](AutomixParameters& p) { p.zeroLatency = b; }); }
+
+    // Message thread. The latency to report to the host for the current settings.
+    int getLatencySamples();
+
+    // Samples per gate/gain decision (default 64). Applies at the next prepare().
+    void setControlBlockSize(int samples) { updateParameters([=](AutomixParameters& p) { p.controlBlockSize = samples; }); }
+
+    // Channel-parallel processing. From parallelThreshold channels up, the per-channel
+    // measure and apply phases are split across workerThreads helper threads
+    // (-1 = one fewer than the number of cores, up to 7). Both apply at the next prepare();
+    // the threshold is also checked every block.
+    void setWorkerThreads(int n)         { updateParameters([=](AutomixParameters& p) { p.workerThreads = n; }); }
+    void setParallelThreshold(int ch)    { updateParameters([=](AutomixParameters& p) { p.parallelThreshold = ch; }); }
+
+    // ML/VAD. The detector runs on a background thread and is picked up at the next
+    // prepare(); without one, speech gating stays off.
+    static constexpr float kSpeechFrameMs = 10.f;
+    void setUseMLSpeechDetection(bool b) { updateParameters([=](AutomixParameters& p) { p.useMLSpeechDetection = b; }); }
+    void setSpeechDetector(std::shared_ptr<MLSpeechDetector> detector);
+
+    // Cross-talk suppression: keeps gates shut on mics that only pick up another mic's talker.
+    void setCrossTalkSuppression(bool b) { updateParameters([=](AutomixParameters& p) { p.useCrossTalkSuppression = b; }); }
+
+    // Worst ML/VAD decision latency since prepare(), in samples: from the end of an
+    // analysed frame to the block that applies its result.
+    int getMaxSpeechLatencySamples() const { return maxSpeechLatency.load(std::memory_order_relaxed); }
+
+    // Per-channel settings. They survive prepare() for channels that still exist.
+    void setChannelMute(int ch, bool b);
+    void setChannelBypass(int ch, bool b);
+    void setChannelAutomixOn(int ch, bool b);
+    void setChannelSensDb(int ch, float dB);
+    void setChannelFaderDb(int ch, float dB);
+
+    // Output matrix for the mixing processBlock(). setChannelPan() places a channel from
+    // the first output (-1) to the last (+1), constant power between the two nearest
+    // outputs and 0 dB on each side of a centred stereo pair. setChannelOutputGain()
+    // sets one entry (linear). Both apply to the outputs of the last prepare().
+    void setChannelPan(int ch, float pan);
+    void setChannelOutputGain(int ch, int output, float gain);
+
+    // Message thread (a single reader thread). The newest MeterFrame, one per
+    // processBlock(). The reference stays valid across prepare(); read its
+    // numChannels rather than assuming the count.
+    const MeterFrame& getMeterFrame() { return meters.read(); }
+
+    // Live channel state. Only safe on the thread that calls processBlock() (offline
+    // rendering, tests); UIs use getMeterFrame().
+    float getChannelShortTermRMS(int ch) const;
+    float getChannelAutoGain(int ch) const;    // linear, as applied; 0 when fully ducked
+    float getChannelAutoGainDb(int ch) const;
+
+private:
+    // Works on samples [start, start + nSamples) of the host buffers;
+    // nSamples never exceeds the block size passed to prepare(). With outputs,
+    // mixes into them instead of writing the channels back.
+    void processChunk(float** audioData, int start, int nSamples,
+                      float** sideData, int sideChs, int sideSamples, float** outputs);
+
+    // Runs fn(begin, end) over the channels, on the worker pool when it is worth it.
+    // Every range but the last holds channelRangeSize(nChannels) channels.
+    template <typename Fn>
+    void forEachChannelRange(int nChannels, Fn&& fn);
+    int channelRangeSize(int nChannels) const;
+
+    // For ML/VAD: applies the results that came back from the analysis thread.
+    void updateMLSpeechStates();
+
+    // Applies edit to the master parameters and publishes a snapshot.
+    template <typename Edit>
+    void updateParameters(Edit&& edit)
+    {
+        std::lock_guard<std::mutex> lock(writerLock);
+        edit(pending);
+        ++pending.version;
+        parameters.getWriteBuffer() = pending;
+        parameters.publish();
+    }
+
+    // Everything the audio thread derives from a parameter snapshot.
+    struct DerivedCoefficients
+    {
+        AutomixChannelState::GateCoefficients gate; // thresholds without adaptive offset
+        float thresholdDb = 0.f;
+        float hysteresisDb = 0.f;
+        float closeLin = 0.f;
+        float master = 1.f;
+        float maxLin = 3.0e38f;
+        float sidechainInfluence = 0.f;
+        float duckThresholdLin = 0.f;
+        float duckDepthLin = 1.f;
+        float duckAttack = 1.f, duckRelease = 1.f; // per control block
+        int laSamples = 0;
+        int parallelThreshold = 0;
+        bool lastMicOn = false;
+        bool useSpeech = false;
+        bool useCrossTalk = false;
+        bool useAdaptiveThreshold = false;
+        bool ducking = false;
+    };
+
+    // Audio thread. Rebuilds `derived` and the channel settings in `channels`.
+    void updateDerived(const AutomixParameters& p);
+
+    // Lookahead in samples for p at the prepared sample rate.
+    int lookaheadSamples(const AutomixParameters& p) const;
+
+    // out = the current block delayed by delaySamples, or crossfading between two delays.
+    void readDelayed(int ch, float* out, int nSamples) const;
+
+    // One control-rate decision from channels.blockRms into channels.finalGain;
+    // duck scales the whole mix.
+    void decide(const AutomixChannelState::GateCoefficients& k, const DerivedCoefficients& d, float duck);
+
+    // End of processBlock(): fills the meter write slot and publishes it.
+    void publishMeters();
+
+    // Audio settings:
+    double sr = 44100.0;
+    int blockSize = 512;
+    int numCh = 0;
+    int sideCh = 0;
+
+    // SIMD kernels picked for this CPU in prepare():
+    const VectorKernels* kernels = &VectorKernels::scalarKernels();
+
+    // Channel-parallel processing:
+    static constexpr int kMaxAutoWorkers = 7;
+    static constexpr int kMinChannelsPerTask = 8;
+    AudioWorkerPool workers;
+
+    // Per-channel settings and state, structure-of-arrays. Audio thread only; the
+    // settings are copied in from the parameter snapshot.
+    AutomixChannelState channels;
+
+    // Mixing: the output matrix (mixOutputs gains per channel, from the parameters), and
+    // one partial mix of mixOutputs buses per channel range, summed into the outputs:
+    int mixOutputs = 0;
+    std::vector<float> outputMatrix;
+    PlanarScratchBuffer mixBuses;
+
+    // Lookahead buffer, and the delay in effect. While fadePosition < fadeLength the
+    // output crossfades from fadeFromDelay to delaySamples:
+    LookaheadRing lookahead;
+    int delaySamples = 0;
+    int fadeFromDelay = 0;
+    int fadePosition = 0;
+    int fadeLength = 1;
+
+    // Control rate. controlPhase is how far into the current control block the
+    // stream is. The scratch buffers hold one plane of numCh values per control
+    // block that completes within a host block:
+    static constexpr int kMaxControlBlockSize = 1024;
+    int controlBlockSize = 64;
+    int controlPhase = 0;
+    PlanarScratchBuffer controlRms;
+    PlanarScratchBuffer controlGains;
+
+    // Sidechain level and the smoothed ducking gain:
+    SidechainDetector sidechain;
+    float duckGain = 1.f;
+
+    // Parameters. pending is the writers' master copy (guarded by writerLock);
+    // parameters carries snapshots of it to the audio thread.
+    std::mutex writerLock;
+    AutomixParameters pending;
+    TripleBuffer<AutomixParameters> parameters;
+
+    // Audio-thread cache, valid for derivedVersion (prepare() bumps the version):
+    DerivedCoefficients derived;
+    std::uint32_t derivedVersion = 0;
+
+    // ML/VAD integration. speechDetector is guarded by writerLock; the rest is set
+    // up in prepare():
+    std::shared_ptr<MLSpeechDetector> speechDetector;
+    SpeechAnalysisThread speechAnalysis;
+    bool speechAvailable = false;
+    std::int64_t streamPosition = 0;
+    std::atomic<int> maxSpeechLatency {0};
+
+    // Cross-talk analysis of the live input, sized in prepare():
+    CrossTalkSuppressor crossTalk;
+
+    int lastActiveChannel = 0;
+    int lastMicChannel = -1;   // held open by "last mic on" in the latest decision, or -1
+
+    // Meter frames to the UI. Peaks accumulate in blockPeak (every channel) during
+    // the block and are copied into the frame with the rest at the end.
+    std::vector<float> blockPeak;
+    TripleBuffer<MeterFrame> meters;
+};
+
+//==============================================================================
+template <typename Policies>
+void DuganAutomixEngine<Policies>::prepare(double sampleRate, int blkSize, int mainChannels, int sideChainCount,
+                                           int outputChannels)
+{
+    sr = sampleRate;
+    blockSize = blkSize;
+    numCh = mainChannels;
+    sideCh = std::clamp(sideChainCount, 0, SidechainDetector::kMaxChannels);
+    mixOutputs = std::max(0, outputChannels);
+    kernels = &VectorKernels::select();
+
+    // Size the per-channel settings and put the same snapshot in every slot, so no
+    // later publish has to allocate:
+    AutomixParameters p;
+    {
+        std::lock_guard<std::mutex> lock(writerLock);
+        pending.resizeChannels(numCh);
+        pending.resizeOutputs(mixOutputs);
+        ++pending.version;
+        parameters.reset(pending);
+        p = pending;
+    }
+
+    channels.resize(numCh);
+    outputMatrix.assign(static_cast<std::size_t>(numCh) * static_cast<std::size_t>(mixOutputs), 1.f);
+
+    controlBlockSize = std::clamp(p.controlBlockSize, 1, kMaxControlBlockSize);
+    controlPhase = 0;
+    sidechain.reset();
+    duckGain = 1.f;
+    const int maxDecisions = (controlBlockSize - 1 + blkSize) / controlBlockSize;
+    controlRms.allocate(maxDecisions, numCh);
+    controlGains.allocate(maxDecisions, numCh);
+
+    if constexpr (Policies::lookahead)
+    {
+        // Room for the longest lookahead plus the block being written, so it can change
+        // live without reallocating:
+        const int maxDelay = static_cast<int>(std::ceil(kMaxLookaheadMs / 1000.0 * sr));
+        lookahead.prepare(numCh, maxDelay + blkSize);
+        delaySamples = lookaheadSamples(p);
+        fadePosition = fadeLength = std::max(1, static_cast<int>(kDelayCrossfadeMs / 1000.0 * sr));
+    }
+
+    lastActiveChannel = 0;
+    lastMicChannel = -1;
+    streamPosition = 0;
+
+    // The meter slots are never reallocated (the UI may be reading one); the new
+    // channel count goes out with the next published frame, starting with this one.
+    blockPeak.assign(static_cast<std::size_t>(numCh), 0.f);
+    publishMeters();
+
+    if constexpr (Policies::speechGating)
+    {
+        std::shared_ptr<MLSpeechDetector> detector;
+        {
+            std::lock_guard<std::mutex> lock(writerLock);
+            detector = speechDetector;
+        }
+        const int frameSize = std::max(1, static_cast<int>(std::lround(kSpeechFrameMs / 1000.0 * sr)));
+        speechAnalysis.start(std::move(detector), numCh, frameSize);
+        speechAvailable = speechAnalysis.isRunning();
+        maxSpeechLatency.store(0, std::memory_order_relaxed);
+    }
+
+    if constexpr (Policies::crossTalkSuppression)
+        crossTalk.prepare(sr, numCh);
+
+    if constexpr (Policies::parallelChannels)
+    {
+        // Worker threads only pay off for large rooms; below the threshold none are spawned.
+        int nWorkers = p.workerThreads;
+        if (nWorkers < 0)
+            nWorkers = std::min(kMaxAutoWorkers, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+        // Falls back to no workers if the OS won't give them realtime priority.
+        workers.start(numCh >= p.parallelThreshold ? std::max(0, nWorkers) : 0, blkSize / sr);
+    }
+
+    // A partial mix per channel range: at most two ranges per thread (see
+    // forEachChannelRange()), and no more than there are channel groups.
+    const int threads = workers.getNumWorkers() + 1;
+    const int maxRanges = threads > 1 ? std::min(2 * threads, (numCh + kMinChannelsPerTask - 1) / kMinChannelsPerTask) : 1;
+    mixBuses.allocate(mixOutputs > 0 ? std::max(1, maxRanges) * mixOutputs : 0, blkSize);
+}
+
+template <typename Policies>
+void DuganAutomixEngine<Policies>::processBlock(float** mainData, int mainCh, int numSamples,
+                                                float** sideData, int sideChs, int sideSamples)
+{
+    processBlock(mainData, mainCh, numSamples, sideData, sideChs, sideSamples, nullptr, 0);
+}
+
+template <typename Policies>
+void DuganAutomixEngine<Policies>::processBlock(float** mainData, int mainCh, int numSamples,
+                                                float** sideData, int sideChs, int sideSamples,
+                                                float** outputs, int numOutputs)
+{
+    RealtimeSafety::ScopedNoAllocation noAlloc;
+
+    if (mainCh != numCh || numCh <= 0 || blockSize <= 0)
+        return;
+    if (outputs != nullptr && (numOutputs != mixOutputs || numOutputs <= 0))
+        return;
+
+    std::fill(blockPeak.begin(), blockPeak.end(), 0.f);
+
+    // Hosts may deliver more than the prepared block size; split so the ring never overruns.
+    for (int start = 0; start < numSamples; start += blockSize)
+    {
+        int n = std::min(blockSize, numSamples - start);
+        int sideN = std::max(0, std::min(n, sideSamples - start));
+        processChunk(mainData, start, n, sideData, sideChs, sideN, outputs);
+    }
+
+    publishMeters();
+}
+
+template <typename Policies>
+void DuganAutomixEngine<Policies>::publishMeters()
+{
+    MeterFrame& frame = meters.getWriteBuffer();
+    const int metered = std::min(channels.size(), MeterFrame::kMaxChannels);
+    const auto n = static_cast<std::size_t>(metered);
+    frame.streamPosition = streamPosition;
+    frame.numChannels = metered;
+    std::memcpy(frame.rms.data(), channels.shortTermRMS, n * sizeof(float));
+    std::memcpy(frame.peak.data(), blockPeak.data(), n * sizeof(float));
+    std::memcpy(frame.gain.data(), channels.finalGain, n * sizeof(float));
+    std::memcpy(frame.gateOpen.data(), channels.gateActive, n);
+    std::memset(frame.lastMic.data(), 0, n);
+    if (lastMicChannel >= 0 && lastMicChannel < metered)
+        frame.lastMic[static_cast<std::size_t>(lastMicChannel)] = 1;
+    meters.publish();
+}
+
+template <typename Policies>
+void DuganAutomixEngine<Policies>::processChunk(float** audioData, int start, int nSamples,
+                                                float** sideData, int sideChs, int sideSamples, float** outputs)
+{
+    const int nChannels = numCh;
+
+    // 1) Latest parameters; coefficients are only recomputed when they changed:
+    const AutomixParameters& params = parameters.read();
+    if (params.version != derivedVersion)
+        updateDerived(params);
+    const DerivedCoefficients& d = derived;
+
+    // 2) Hand the live input to the speech analysis and collect its latest results:
+    if constexpr (Policies::speechGating)
+    {
+        if (d.useSpeech)
+        {
+            speechAnalysis.pushAudio(audioData, start, nSamples, streamPosition);
+            updateMLSpeechStates();
+        }
+    }
+
+    // 3) Cross-talk: which mics carry only another mic's talker (serial, one FFT per
+    //    channel per hop):
+    if constexpr (Policies::crossTalkSuppression)
+    {
+        if (d.useCrossTalk)
+        {
+            crossTalk.process(audioData, start, nSamples);
+            std::memcpy(channels.bleed, crossTalk.getBleedMask(), static_cast<std::size_t>(nChannels));
+        }
+    }
+
+    const int cb = controlBlockSize;
+    const int phase0 = controlPhase;
+    const int numDecisions = (phase0 + nSamples) / cb;
+    // Start a crossfade if the lookahead changed (one at a time; a newer change waits):
+    if constexpr (Policies::lookahead)
+    {
+        if (fadePosition >= fadeLength && d.laSamples != delaySamples)
+        {
+            fadeFromDelay = delaySamples;
+            delaySamples = d.laSamples;
+            fadePosition = 0;
+        }
+    }
+
+    // 4) Copy to the ring, take the block peak for the meters, and measure the live input's
+    //    RMS for every control block that completes here; partial sums carry over to the
+    //    next host block. Split across the
+    //    worker pool for large channel counts:
+    float* sumSquares = channels.sumSquares;
+    float* peak = blockPeak.data();
+    forEachChannelRange(nChannels, [&](int begin, int end)
+    {
+        for (int ch = begin; ch < end; ++ch)
+        {
+            const float* detect = audioData[ch] + start;
+            if constexpr (Policies::lookahead)
+                lookahead.write(ch, detect, nSamples);
+            peak[ch] = std::max(peak[ch], kernels->peak(detect, nSamples));
+            if constexpr (!Policies::meterMutedChannels)
+            {
+                if (channels.mute[ch])
+                {
+                    sumSquares[ch] = 0.f;
+                    continue;
+                }
+            }
+
+            float acc = sumSquares[ch];
+            int phase = phase0, decision = 0;
+            for (int pos = 0; pos < nSamples;)
+            {
+                const int len = std::min(nSamples - pos, cb - phase);
+                acc += kernels->sumSquares(detect + pos, len);
+                pos += len;
+                phase += len;
+                if (phase == cb)
+                {
+                    controlRms.getWritePointer(decision++)[ch] = std::sqrt(acc / static_cast<float>(cb));
+                    acc = 0.f;
+                    phase = 0;
+                }
+            }
+            sumSquares[ch] = acc;
+        }
+    });
+
+    // 5) Decisions, in stream order. They need all channels, so they run serially after
+    //    the barrier at the end of forEachChannelRange(); each pass is vectorised across
+    //    channels instead:
+    const int numSide = std::min(sideChs, sideCh);
+    const bool measureSide = (d.useAdaptiveThreshold || d.ducking) && numSide > 0 && sideData != nullptr;
+    const std::size_t rmsBytes = static_cast<std::size_t>(nChannels) * sizeof(float);
+    int sidePos = 0;
+    for (int decision = 0; decision < numDecisions; ++decision)
+    {
+        // Sidechain level over this control block:
+        float sideLevel = 0.f;
+        if (measureSide)
+        {
+            const int blockEnd = (decision + 1) * cb - phase0;
+            // A sidechain block shorter than the main one runs out part way; the level
+            // is then over the samples it did supply (see SidechainDetector).
+            const int len = std::max(0, std::min(blockEnd, sideSamples) - sidePos);
+            sidechain.accumulate(*kernels, sideData, numSide, start + sidePos, len);
+            sidePos = blockEnd;
+            sideLevel = sidechain.takeLevel();
+        }
+
+        // Gate threshold, offset by the sidechain level if enabled:
+        AutomixChannelState::GateCoefficients k = d.gate;
+        if constexpr (Policies::AdaptiveThreshold::enabled)
+        {
+            if (d.useAdaptiveThreshold)
+            {
+                const float sideDb = measureSide ? FastMath::linearToDb(sideLevel) : -90.f;
+                float threshold = d.thresholdDb + Policies::AdaptiveThreshold::offsetDb(d.sidechainInfluence, sideDb);
+                k.gateOnLin = FastMath::dbToLinear(threshold + d.hysteresisDb);
+                k.gateOffLin = FastMath::dbToLinear(threshold - d.hysteresisDb);
+            }
+        }
+
+        // Ducking; with it off the gain still releases back to unity:
+        const float duckTarget = d.ducking && sideLevel > d.duckThresholdLin ? d.duckDepthLin : 1.f;
+        duckGain += (duckTarget < duckGain ? d.duckAttack : d.duckRelease) * (duckTarget - duckGain);
+
+        std::memcpy(channels.blockRms, controlRms.getReadPointer(decision), rmsBytes);
+        decide(k, d, duckGain);
+        std::memcpy(controlGains.getWritePointer(decision), channels.finalGain, rmsBytes);
+    }
+    if (measureSide && sidePos < sideSamples)
+        sidechain.accumulate(*kernels, sideData, numSide, start + sidePos, sideSamples - sidePos);
+
+    // 6) Apply the gains to the delayed audio. Each decision ramps in over the control
+    //    block after it; a ramp split by a host block boundary continues where it left off.
+    //    When mixing, each gained segment is accumulated into the range's partial mix
+    //    rather than written back, so the channel is read once and never stored:
+    float* appliedGain = channels.appliedGain;
+    float* targetGain = channels.targetGain;
+    const float invCb = 1.f / static_cast<float>(cb);
+    const int numOut = outputs != nullptr ? mixOutputs : 0;
+    const int rangeSize = channelRangeSize(nChannels);
+    const std::size_t chunkBytes = sizeof(float) * static_cast<std::size_t>(nSamples);
+    forEachChannelRange(nChannels, [&](int begin, int end)
+    {
+        float* const* mix = nullptr;
+        if (numOut > 0)
+        {
+            mix = mixBuses.getArrayOfWritePointers() + (begin / rangeSize) * numOut;
+            for (int o = 0; o < numOut; ++o)
+                std::memset(mix[o], 0, chunkBytes);
+        }
+
+        for (int ch = begin; ch < end; ++ch)
+        {
+            float* out = audioData[ch] + start;
+            if constexpr (Policies::lookahead)
+                readDelayed(ch, out, nSamples);
+            const float* row = outputMatrix.data() + static_cast<std::size_t>(ch) * static_cast<std::size_t>(numOut);
+
+            float from = appliedGain[ch], to = targetGain[ch];
+            int phase = phase0, decision = 0;
+            for (int pos = 0; pos < nSamples;)
+            {
+                const int len = std::min(nSamples - pos, cb - phase);
+                const float step = (to - from) * invCb;
+                const float g0 = from + step * static_cast<float>(phase);
+                const float g1 = from + step * static_cast<float>(phase + len);
+                if (mix == nullptr)
+                {
+                    if (from == to)
+                        kernels->scaleInPlace(out + pos, len, to);
+                    else
+                        kernels->scaleInPlaceRamp(out + pos, len, g0, g1);
+                }
+                else
+                {
+                    for (int o = 0; o < numOut; ++o)
+                    {
+                        const float m = row[o];
+                        if (from == to)
+                        {
+                            if (to * m != 0.f)
+                                kernels->scaleAndAccumulate(mix[o] + pos, out + pos, len, to * m);
+                        }
+                        else
+                        {
+                            kernels->scaleAndAccumulateRamp(mix[o] + pos, out + pos, len, g0 * m, g1 * m);
+                        }
+                    }
+                }
+                pos += len;
+                phase += len;
+                if (phase == cb)
+                {
+                    from = to;
+                    to = controlGains.getReadPointer(decision++)[ch];
+                    phase = 0;
+                }
+            }
+            appliedGain[ch] = from;
+            targetGain[ch] = to;
+        }
+    });
+
+    // 7) Mixing: sum the partial mixes into the outputs. Every input has been read by
+    //    now, so an output that shares storage with an input is safe to overwrite:
+    if (numOut > 0)
+    {
+        const int numRanges = (nChannels + rangeSize - 1) / rangeSize;
+        for (int o = 0; o < numOut; ++o)
+        {
+            float* dst = outputs[o] + start;
+            std::memcpy(dst, mixBuses.getReadPointer(o), chunkBytes);
+            for (int range = 1; range < numRanges; ++range)
+                kernels->scaleAndAccumulate(dst, mixBuses.getReadPointer(range * numOut + o), nSamples, 1.f);
+        }
+    }
+
+    controlPhase = (phase0 + nSamples) % cb;
+    streamPosition += nSamples;
+    if constexpr (Policies::lookahead)
+    {
+        lookahead.advance(nSamples);
+        fadePosition = std::min(fadeLength, fadePosition + nSamples);
+    }
+}
+
+template <typename Policies>
+void DuganAutomixEngine<Policies>::readDelayed(int ch, float* out, int nSamples) const
+{
+    // The live block is at delay 0, already in out.
+    if (fadePosition >= fadeLength)
+    {
+        if (delaySamples > 0)
+            std::memcpy(out, lookahead.getReadPointer(ch, delaySamples), sizeof(float) * static_cast<std::size_t>(nSamples));
+        return;
+    }
+
+    const float* from = lookahead.getReadPointer(ch, fadeFromDelay);
+    const float* to = lookahead.getReadPointer(ch, delaySamples);
+    const float step = 1.f / static_cast<float>(fadeLength);
+    for (int i = 0; i < nSamples; ++i)
+    {
+        const float t = std::min(1.f, static_cast<float>(fadePosition + i + 1) * step);
+        out[i] = from[i] + (to[i] - from[i]) * t;
+    }
+}
+
+template <typename Policies>
+void DuganAutomixEngine<Policies>::decide(const AutomixChannelState::GateCoefficients& k,
+                                          const DerivedCoefficients& d, float duck)
+{
+    // Smoothing and gate envelopes, vectorised across channels:
+    channels.updateGates(k, Policies::meterMutedChannels, d.useSpeech, d.useCrossTalk);
+
+    // Last mic on logic:
+    const int loudestCh = channels.loudestOpenGate();
+    if (loudestCh < 0 && d.lastMicOn)
+    {
+        channels.gateActive[lastActiveChannel] = 1;
+        channels.gateEnv[lastActiveChannel] = 1.f;
+    }
+    else if (loudestCh >= 0)
+    {
+        lastActiveChannel = loudestCh;
+    }
+
+    // For the meters: the last active mic is held by "last mic on" once its level is
+    // below the close threshold (its own gate would be releasing).
+    const int held = lastActiveChannel;
+    const bool belowThreshold = channels.shortTermRMS[held] * channels.sensLin[held] <= k.gateOffLin;
+    lastMicChannel = d.lastMicOn && channels.gateActive[held] && belowThreshold ? held : -1;
+
+    // Gain sharing, fader/master and leveler clamp; ducking scales the clamp too so it
+    // still applies to channels sitting at the leveler limit:
+    channels.computeGains(d.closeLin, d.master * duck, d.maxLin * duck);
+}
+
+template <typename Policies>
+template <typename Fn>
+void DuganAutomixEngine<Policies>::forEachChannelRange(int nChannels, Fn&& fn)
+{
+    const int grain = channelRangeSize(nChannels);
+    if (grain < nChannels)
+        workers.parallelFor(nChannels, grain, fn);
+    else
+        fn(0, nChannels);
+}
+
+template <typename Policies>
+int DuganAutomixEngine<Policies>::channelRangeSize(int nChannels) const
+{
+    if constexpr (Policies::parallelChannels)
+    {
+        const int threads = workers.getNumWorkers() + 1;
+        if (threads > 1 && nChannels >= derived.parallelThreshold)
+        {
+            // About two ranges per thread evens out uneven per-channel cost (muted channels
+            // may skip the measurement); at least a few channels each so dispatch stays cheap.
+            return std::max(kMinChannelsPerTask, (nChannels + 2 * threads - 1) / (2 * threads));
+        }
+    }
+    return std::max(1, nChannels);
+}
+
+template <typename Policies>
+int DuganAutomixEngine<Policies>::lookaheadSamples(const AutomixParameters& p) const
+{
+    if (!Policies::lookahead || p.zeroLatency)
+        return 0;
+    const float ms = std::clamp(p.lookaheadMs, 0.f, kMaxLookaheadMs);
+    return static_cast<int>(std::ceil(ms / 1000.0 * sr));
+}
+
+template <typename Policies>
+int DuganAutomixEngine<Policies>::getLatencySamples()
+{
+    std::lock_guard<std::mutex> lock(writerLock);
+    return lookaheadSamples(pending);
+}
+
+template <typename Policies>
+void DuganAutomixEngine<Policies>::updateDerived(const AutomixParameters& p)
+{
+    DerivedCoefficients& d = derived;
+
+    // One-pole coefficients per control block, so the time constants hold at any host
+    // block size. Gate decisions run on linear RMS; only the thresholds are converted:
+    const double cb = controlBlockSize;
+    d.gate.stCoef = static_cast<float>(std::exp(-cb / ((p.shortTermMs / 1000.0) * sr + 1e-9)));
+    d.gate.ltCoef = static_cast<float>(std::exp(-cb / ((p.longTermMs / 1000.0) * sr + 1e-9)));
+    d.gate.gateOnLin = FastMath::dbToLinear(p.gateThreshold + p.gateHysteresis);
+    d.gate.gateOffLin = FastMath::dbToLinear(p.gateThreshold - p.gateHysteresis);
+    d.gate.attCoeff = static_cast<float>(1.0 - std::exp(-cb / (p.gateAttackMs * 0.001 * sr + 1e-9)));
+    d.gate.relCoeff = static_cast<float>(1.0 - std::exp(-cb / (p.gateReleaseMs * 0.001 * sr + 1e-9)));
+
+    d.thresholdDb = p.gateThreshold;
+    d.hysteresisDb = p.gateHysteresis;
+    d.closeLin = FastMath::dbToLinear(p.gateCloseDb);
+    d.master = p.masterGain;
+    d.maxLin = Policies::leveler && p.linkLeveler ? FastMath::dbToLinear(p.levelerRangeDb) : 3.0e38f;
+    d.sidechainInfluence = p.sidechainInfluence;
+    d.ducking = p.duckingEnabled;
+    d.duckThresholdLin = FastMath::dbToLinear(p.duckThresholdDb);
+    d.duckDepthLin = FastMath::dbToLinear(-std::abs(p.duckDepthDb));
+    d.duckAttack = static_cast<float>(1.0 - std::exp(-cb / (p.duckAttackMs * 0.001 * sr + 1e-9)));
+    d.duckRelease = static_cast<float>(1.0 - std::exp(-cb / (p.duckReleaseMs * 0.001 * sr + 1e-9)));
+    d.parallelThreshold = p.parallelThreshold;
+    d.lastMicOn = p.lastMicOn;
+    d.useSpeech = Policies::speechGating && p.useMLSpeechDetection && speechAvailable;
+    d.useCrossTalk = Policies::crossTalkSuppression && p.useCrossTalkSuppression;
+    d.useAdaptiveThreshold = Policies::AdaptiveThreshold::enabled && p.useAdaptiveThreshold;
+
+    d.laSamples = lookaheadSamples(p);
+
+    // Channel settings, with their linear gains:
+    const int n = std::min(channels.size(), p.getNumChannels());
+    for (int ch = 0; ch < n; ++ch)
+    {
+        const auto i = static_cast<std::size_t>(ch);
+        channels.mute[ch] = p.mute[i];
+        channels.bypass[ch] = p.bypass[i];
+        channels.automix[ch] = p.automix[i];
+        channels.sensDb[ch] = p.sensDb[i];
+        channels.faderDb[ch] = p.faderDb[i];
+        channels.sensLin[ch] = FastMath::dbToLinear(p.sensDb[i]);
+        channels.faderLin[ch] = FastMath::dbToLinear(p.faderDb[i]);
+    }
+    if (p.numOutputs == mixOutputs && p.outputGains.size() >= outputMatrix.size())
+        std::copy(p.outputGains.begin(), p.outputGains.begin() + static_cast<std::ptrdiff_t>(outputMatrix.size()),
+                  outputMatrix.begin());
+
+    derivedVersion = p.version;
+}
+
+template <typename Policies>
+void DuganAutomixEngine<Policies>::setChannelMute(int ch, bool b)
+{
+    updateParameters([=](AutomixParameters& p) {
+        if (ch >= 0 && ch < p.getNumChannels())
+            p.mute[static_cast<std::size_t>(ch)] = b ? 1 : 0;
+    });
+}
+
+template <typename Policies>
+void DuganAutomixEngine<Policies>::setChannelBypass(int ch, bool b)
+{
+    updateParameters([=](AutomixParameters& p) {
+        if (ch >= 0 && ch < p.getNumChannels())
+            p.bypass[static_cast<std::size_t>(ch)] = b ? 1 : 0;
+    });
+}
+
+template <typename Policies>
+void DuganAutomixEngine<Policies>::setChannelAutomixOn(int ch, bool b)
+{
+    updateParameters([=](AutomixParameters& p) {
+        if (ch >= 0 && ch < p.getNumChannels())
+            p.automix[static_cast<std::size_t>(ch)] = b ? 1 : 0;
+    });
+}
+
+template <typename Policies>
+void DuganAutomixEngine<Policies>::setChannelSensDb(int ch, float dB)
+{
+    updateParameters([=](AutomixParameters& p) {
+        if (ch >= 0 && ch < p.getNumChannels())
+            p.sensDb[static_cast<std::size_t>(ch)] = dB;
+    });
+}
+
+template <typename Policies>
+void DuganAutomixEngine<Policies>::setChannelFaderDb(int ch, float dB)
+{
+    updateParameters([=](AutomixParameters& p) {
+        if (ch >= 0 && ch < p.getNumChannels())
+            p.faderDb[static_cast<std::size_t>(ch)] = dB;
+    });
+}
+
+template <typename Policies>
+void DuganAutomixEngine<Policies>::setChannelPan(int ch, float pan)
+{
+    updateParameters([=](AutomixParameters& p) {
+        if (ch < 0 || ch >= p.getNumChannels() || p.numOutputs <= 0)
+            return;
+        float* row = p.outputGains.data() + static_cast<std::size_t>(ch) * static_cast<std::size_t>(p.numOutputs);
+        std::fill(row, row + p.numOutputs, 0.f);
+        if (p.numOutputs == 1)
+        {
+            row[0] = 1.f;
+            return;
+        }
+
+        // Position between outputs, then a sin/cos law between the two nearest, scaled so
+        // the midpoint of a pair is 0 dB on both:
+        const float position = (std::clamp(pan, -1.f, 1.f) + 1.f) * 0.5f * static_cast<float>(p.numOutputs - 1);
+        const int left = std::min(static_cast<int>(position), p.numOutputs - 2);
+        const float angle = (position - static_cast<float>(left)) * 1.5707963f;
+        row[left] = 1.4142136f * std::cos(angle);
+        row[left + 1] = 1.4142136f * std::sin(angle);
+    });
+}
+
+template <typename Policies>
+void DuganAutomixEngine<Policies>::setChannelOutputGain(int ch, int output, float gain)
+{
+    updateParameters([=](AutomixParameters& p) {
+        if (ch >= 0 && ch < p.getNumChannels() && output >= 0 && output < p.numOutputs)
+            p.outputGains[static_cast<std::size_t>(ch) * static_cast<std::size_t>(p.numOutputs)
+                          + static_cast<std::size_t>(output)] = gain;
+    });
+}
+
+template <typename Policies>
+float DuganAutomixEngine<Policies>::getChannelShortTermRMS(int ch) const
+{
+    if (ch < 0 || ch >= channels.size())
+        return 0.f;
+    return channels.shortTermRMS[ch];
+}
+
+template <typename Policies>
+float DuganAutomixEngine<Policies>::getChannelAutoGain(int ch) const
+{
+    if (ch < 0 || ch >= channels.size())
+        return 0.f;
+    return channels.finalGain[ch];
+}
+
+template <typename Policies>
+float DuganAutomixEngine<Policies>::getChannelAutoGainDb(int ch) const
+{
+    if (ch < 0 || ch >= channels.size())
+        return 0.f;
+    return FastMath::linearToDb(channels.finalGain[ch]);
+}
+
+template <typename Policies>
+void DuganAutomixEngine<Policies>::setSpeechDetector(std::shared_ptr<MLSpeechDetector> detector)
+{
+    std::lock_guard<std::mutex> lock(writerLock);
+    speechDetector = std::move(detector);
+}
+
+template <typename Policies>
+void DuganAutomixEngine<Policies>::updateMLSpeechStates()
+{
+    // Results arrive in frame order, so the last one per channel wins.
+    int worstLatency = 0;
+    SpeechResult result;
+    while (speechAnalysis.popResult(result))
+    {
+        if (result.channel < channels.size())
+            channels.speechActive[result.channel] = result.isActive ? 1 : 0;
+        worstLatency = std::max(worstLatency, static_cast<int>(streamPosition - result.frameEnd));
+    }
+
+    if (worstLatency > maxSpeechLatency.load(std::memory_order_relaxed))
+        maxSpeechLatency.store(worstLatency, std::memory_order_relaxed);
+}
@@ -1,46 +1,190 @@
 // LockFreeFifo.h
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <cstddef>
+#include <utility>
 #include <vector>
 
+/**
+    LockFreeFifo:
+    - A bounded queue from exactly one producer thread to exactly one consumer
+      thread, with no locks and no allocation after construction.
+    - The capacity is rounded up to a power of two and every slot is usable.
+      The indices count up freely and are masked on access, so no operation
+      divides.
+    - Each side's index lives on its own cache line, next to that side's cached
+      copy of the other index. A side only reloads the other's index (and pulls
+      its cache line across) when the cached copy says the queue is full/empty.
+    - push()/pop() move single items. pushN()/popN() move a run of items with
+      one index update, and prepareToWrite()/prepareToRead() hand out the free
+      or ready region directly as at most two contiguous segments (two when
+      the region wraps), for filling or draining in place.
+    - T needs a default constructor (slots are constructed up front) and move
+      assignment; copyable isn't required unless the copying push()/pushN()
+      are used. pop() moves items out, leaving a moved-from T in the slot.
+*/
 template <typename T>
 class LockFreeFifo
 {
 public:
-    LockFreeFifo(size_t capacity)
-        : capacity(capacity), buffer(capacity)
+    // A region of the ring: first[0..firstSize), then second[0..secondSize).
+    struct Segments
+    {
+        T* first = nullptr;
+        std::size_t firstSize = 0;
+        T* second = nullptr;
+        std::size_t secondSize = 0;
+
+        std::size_t size() const { return firstSize + secondSize; }
+    };
+
+    // Holds at least minCapacity items.
+    explicit LockFreeFifo(std::size_t minCapacity)
+        : buffer(roundUpToPowerOfTwo(minCapacity)), mask(buffer.size() - 1)
     {
-        writeIndex.store(0);
-        readIndex.store(0);
     }
 
-    bool push(const T& item)
+    LockFreeFifo(const LockFreeFifo&) = delete;
+    LockFreeFifo& operator=(const LockFreeFifo&) = delete;
+
+    std::size_t getCapacity() const { return buffer.size(); }
+
+    //==============================================================================
+    // Producer side.
+
+    bool push(const T& item) { return emplace(item); }
+    bool push(T&& item)      { return emplace(std::move(item)); }
+
+    // Copies up to n items and returns how many fitted.
+    std::size_t pushN(const T* items, std::size_t n)
     {
-        auto w = writeIndex.load(std::memory_order_relaxed);
-        auto r = readIndex.load(std::memory_order_acquire);
-        auto next = (w + 1) % capacity;
-        if (next == r)
-            return false; // buffer is full
-        buffer[w] = item;
-        writeIndex.store(next, std::memory_order_release);
-        return true;
+        auto s = prepareToWrite(n);
+        std::copy(items, items + s.firstSize, s.first);
+        std::copy(items + s.firstSize, items + s.size(), s.second);
+        finishedWrite(s.size());
+        return s.size();
+    }
+
+    // The free slots, up to maxItems of them. Fill them, then finishedWrite().
+    Segments prepareToWrite(std::size_t maxItems)
+    {
+        const auto w = producer.index.load(std::memory_order_relaxed);
+        auto free = buffer.size() - (w - producer.cachedOther);
+        if (free < maxItems)
+        {
+            producer.cachedOther = consumer.index.load(std::memory_order_acquire);
+            free = buffer.size() - (w - producer.cachedOther);
+        }
+        return segmentsAt(w, std::min(free, maxItems));
     }
 
+    // Publishes the first n slots of the last prepareToWrite() region.
+    void finishedWrite(std::size_t n)
+    {
+        producer.index.store(producer.index.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    //==============================================================================
+    // Consumer side.
+
     bool pop(T& outItem)
     {
-        auto r = readIndex.load(std::memory_order_relaxed);
-        auto w = writeIndex.load(std::memory_order_acquire);
-        if (r == w)
-            return false; // buffer is empty
-        outItem = buffer[r];
-        r = (r + 1) % capacity;
-        readIndex.store(r, std::memory_order_release);
+        const auto r = consumer.index.load(std::memory_order_relaxed);
+        if (r == consumer.cachedOther)
+        {
+            consumer.cachedOther = producer.index.load(std::memory_order_acquire);
+            if (r == consumer.cachedOther)
+                return false; // empty
+        }
+        outItem = std::move(buffer[r & mask]);
+        consumer.index.store(r + 1, std::memory_order_release);
         return true;
     }
 
+    // Moves up to n items into out and returns how many there were.
+    std::size_t popN(T* out, std::size_t n)
+    {
+        auto s = prepareToRead(n);
+        std::move(s.first, s.first + s.firstSize, out);
+        std::move(s.second, s.second + s.secondSize, out + s.firstSize);
+        finishedRead(s.size());
+        return s.size();
+    }
+
+    // The ready items, up to maxItems of them. Read them, then finishedRead().
+    Segments prepareToRead(std::size_t maxItems)
+    {
+        const auto r = consumer.index.load(std::memory_order_relaxed);
+        auto ready = consumer.cachedOther - r;
+        if (ready < maxItems)
+        {
+            consumer.cachedOther = producer.index.load(std::memory_order_acquire);
+            ready = consumer.cachedOther - r;
+        }
+        return segmentsAt(r, std::min(ready, maxItems));
+    }
+
+    // Releases the first n items of the last prepareToRead() region.
+    void finishedRead(std::size_t n)
+    {
+        consumer.index.store(consumer.index.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    // Either side: a snapshot that may be stale by the time it's used.
+    std::size_t getNumReady() const
+    {
+        return producer.index.load(std::memory_order_acquire) - consumer.index.load(std::memory_order_acquire);
+    }
+
 private:
-    size_t capacity;
+    static constexpr std::size_t kCacheLine = 64;
+
+    // One side's index and its cached copy of the other side's.
+    struct alignas(kCacheLine) Side
+    {
+        std::atomic<std::size_t> index { 0 };
+        std::size_t cachedOther = 0;
+    };
+
+    static std::size_t roundUpToPowerOfTwo(std::size_t n)
+    {
+        std::size_t p = 1;
+        while (p < n)
+            p <<= 1;
+        return p;
+    }
+
+    template <typename U>
+    bool emplace(U&& item)
+    {
+        const auto w = producer.index.load(std::memory_order_relaxed);
+        if (w - producer.cachedOther == buffer.size())
+        {
+            producer.cachedOther = consumer.index.load(std::memory_order_acquire);
+            if (w - producer.cachedOther == buffer.size())
+                return false; // full
+        }
+        buffer[w & mask] = std::forward<U>(item);
+        producer.index.store(w + 1, std::memory_order_release);
+        return true;
+    }
+
+    Segments segmentsAt(std::size_t position, std::size_t n)
+    {
+        const auto start = position & mask;
+        Segments s;
+        s.first = buffer.data() + start;
+        s.firstSize = std::min(n, buffer.size() - start);
+        s.second = buffer.data();
+        s.secondSize = n - s.firstSize;
+        return s;
+    }
+
     std::vector<T> buffer;
-    std::atomic<size_t> writeIndex, readIndex;
+    const std::size_t mask;
+
+    Side producer; // written by the producer only
+    Side consumer; // written by the consumer only
 };
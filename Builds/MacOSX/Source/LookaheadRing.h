@@ -0,0 +1,96 @@
+// LookaheadRing.h
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+/**
+    LookaheadRing:
+    - Multichannel delay line for the lookahead path.
+    - Capacity is rounded up to a power of two so positions wrap with a mask
+      instead of an integer modulo.
+    - Storage is mirrored (each channel holds 2 x capacity samples and every
+      sample is written to both halves), so any window of up to `capacity`
+      samples is contiguous in memory. Readers get a plain pointer into the
+      ring and never copy the delayed block out.
+    - A write of n samples is at most two memcpy segments per half.
+*/
+class LookaheadRing
+{
+public:
+    LookaheadRing() = default;
+
+    // Message thread only. Capacity becomes the next power of two >= minCapacity.
+    void prepare(int numChannels, int minCapacity)
+    {
+        numChans = std::max(0, numChannels);
+        capacity = 1;
+        while (capacity < std::max(1, minCapacity))
+            capacity <<= 1;
+        mask = capacity - 1;
+
+        storage.assign(static_cast<size_t>(numChans) * static_cast<size_t>(2 * capacity), 0.f);
+        writePos = 0;
+    }
+
+    void reset()
+    {
+        std::fill(storage.begin(), storage.end(), 0.f);
+        writePos = 0;
+    }
+
+    int getCapacity() const    { return capacity; }
+    int getNumChannels() const { return numChans; }
+
+    // Copies n samples into channel ch at the current write position.
+    // Call for every channel, then advance(n) once.
+    void write(int ch, const float* src, int n)
+    {
+        assert(ch >= 0 && ch < numChans);
+        assert(n >= 0 && n <= capacity);
+
+        float* base = channelBase(ch);
+        const int first = std::min(n, capacity - writePos);
+        const size_t firstBytes = static_cast<size_t>(first) * sizeof(float);
+        const size_t restBytes  = static_cast<size_t>(n - first) * sizeof(float);
+
+        std::memcpy(base + writePos, src, firstBytes);
+        std::memcpy(base + writePos + capacity, src, firstBytes);
+        if (restBytes > 0)
+        {
+            std::memcpy(base, src + first, restBytes);
+            std::memcpy(base + capacity, src + first, restBytes);
+        }
+    }
+
+    /** Contiguous view of the block starting `delay` samples before the current
+        write position. Valid for numSamples <= capacity - delay; the pointer
+        stays valid until the next write(). */
+    const float* getReadPointer(int ch, int delay) const
+    {
+        assert(ch >= 0 && ch < numChans);
+        assert(delay >= 0 && delay <= capacity);
+        return channelBase(ch) + ((writePos - delay) & mask);
+    }
+
+    void advance(int n) { writePos = (writePos + n) & mask; }
+
+private:
+    float* channelBase(int ch)
+    {
+        return storage.data() + static_cast<size_t>(ch) * static_cast<size_t>(2 * capacity);
+    }
+
+    const float* channelBase(int ch) const
+    {
+        return storage.data() + static_cast<size_t>(ch) * static_cast<size_t>(2 * capacity);
+    }
+
+    std::vector<float> storage;
+    int numChans = 0;
+    int capacity = 0;
+    int mask = 0;
+    int writePos = 0;
+};
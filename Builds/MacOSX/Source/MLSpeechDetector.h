@@ -4,6 +4,15 @@
     A stub for a machine-learning speech detector.
     You can integrate a TensorFlow Lite model or an external library.
     Purely virtual interface here.
+
+    Both calls run on SpeechAnalysisThread's background thread, never on the
+    audio thread, so they may take their time.
+
+    The engine calls detectSpeechBatch() once per frame with every channel.
+    Models that can run all channels as one matrix operation should override
+    it (mdp_batch_detect_bench shows the gain). The default adapts it to one
+    detectSpeech() call per channel, in channel order, so a single-channel
+    detector needs nothing more.
 */
 class MLSpeechDetector
 {
@@ -13,4 +22,14 @@ public:
 
     // Provide raw audio data for one channel; return true if likely speech
     virtual bool detectSpeech(const float* samples, int numSamples, int channelIndex) = 0;
+
+    // frames[ch] holds numSamples samples of channel ch. Writes the probability that
+    // each channel carries speech, 0..1, to probabilities[ch]; above 0.5 counts as speech.
+    virtual void detectSpeechBatch(const float* const* frames, int numChannels, int numSamples, float* probabilities)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            probabilities[ch] = detectSpeech(frames[ch], numSamples, ch) ? 1.f : 0.f;
+    }
+
+    static constexpr float kSpeechThreshold = 0.5f;
 };
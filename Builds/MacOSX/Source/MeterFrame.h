@@ -0,0 +1,32 @@
+// MeterFrame.h
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+    MeterFrame:
+    - Everything a UI meters, for every channel, as of the end of one
+      processBlock(). The engine publishes one per block through a TripleBuffer,
+      so a UI reads a consistent frame instead of polling fields the audio
+      thread is writing.
+    - Fixed capacity of kMaxChannels, so no slot is ever reallocated: a reader
+      can hold a frame across a prepare() that changes the channel count, and
+      only numChannels entries of it are meaningful. Engines with more channels
+      meter the first kMaxChannels.
+*/
+struct MeterFrame
+{
+    static constexpr int kMaxChannels = 64;
+
+    std::int64_t streamPosition = 0;    // samples processed when the frame was taken
+    int numChannels = 0;                // entries in use below
+
+    std::array<float, kMaxChannels> rms {};     // short-term RMS of the input, linear
+    std::array<float, kMaxChannels> peak {};    // input peak over the block, linear
+    std::array<float, kMaxChannels> gain {};    // automix gain, linear
+    std::array<std::uint8_t, kMaxChannels> gateOpen {};
+    std::array<std::uint8_t, kMaxChannels> lastMic {};  // 1 on the channel held open by "last mic on"
+
+    int getNumChannels() const { return numChannels; }
+};
@@ -0,0 +1,59 @@
+// PlanarScratchBuffer.h
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+/**
+    PlanarScratchBuffer:
+    - One contiguous allocation holding numChannels x numSamples floats.
+    - Sized once from prepare(); the audio thread only ever asks for pointers,
+      so nothing on the processing path touches the heap.
+    - Each channel starts on a 64-byte boundary relative to the block start
+      so vector loads don't straddle cache lines between channels.
+*/
+class PlanarScratchBuffer
+{
+public:
+    PlanarScratchBuffer() = default;
+
+    // Message thread only: (re)allocate for the given maximum sizes.
+    void allocate(int numChannels, int maxSamples)
+    {
+        numChans = numChannels > 0 ? numChannels : 0;
+        maxSamps = maxSamples > 0 ? maxSamples : 0;
+        stride = (maxSamps + kAlignFloats - 1) / kAlignFloats * kAlignFloats;
+
+        storage.assign(static_cast<size_t>(numChans) * static_cast<size_t>(stride), 0.f);
+        channelPointers.resize(static_cast<size_t>(numChans));
+        for (int ch = 0; ch < numChans; ++ch)
+            channelPointers[static_cast<size_t>(ch)] = storage.data() + static_cast<size_t>(ch) * stride;
+    }
+
+    int getNumChannels() const { return numChans; }
+    int getMaxSamples() const  { return maxSamps; }
+
+    float* getWritePointer(int ch)
+    {
+        assert(ch >= 0 && ch < numChans);
+        return channelPointers[static_cast<size_t>(ch)];
+    }
+
+    const float* getReadPointer(int ch) const
+    {
+        assert(ch >= 0 && ch < numChans);
+        return channelPointers[static_cast<size_t>(ch)];
+    }
+
+    float** getArrayOfWritePointers() { return channelPointers.data(); }
+
+private:
+    static constexpr int kAlignFloats = 16; // 64 bytes
+
+    std::vector<float> storage;
+    std::vector<float*> channelPointers;
+    int numChans = 0;
+    int maxSamps = 0;
+    int stride = 0;
+};
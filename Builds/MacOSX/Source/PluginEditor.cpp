@@ -13,14 +13,11 @@ MyDuganPluginAudioProcessorEditor::MyDuganPluginAudioProcessorEditor (MyDuganPlu
     // Apply our custom LookAndFeel to the entire editor
     setLookAndFeel(&customLF);
     
-    // Create channel strips
-    for (int i = 0; i < 4; ++i)
-    {
-        auto channelName = "Ch " + juce::String(i + 1);
-        auto* strip = new ChannelStripComponent(audioProcessor.parameters, channelName);
-        channelStrips.add(strip);
-        addAndMakeVisible(strip);
-    }
+    // Channel strips, one per input, in a horizontally scrolling row
+    stripViewport.setViewedComponent(&stripContainer, false);
+    stripViewport.setScrollBarsShown(false, true);
+    addAndMakeVisible(stripViewport);
+    updateChannelStrips();
     
     // Master gain slider
     addAndMakeVisible(masterGainSlider);
@@ -48,8 +45,18 @@ void MyDuganPluginAudioProcessorEditor::paint (juce::Graphics& g)
     g.fillAll(juce::Colours::black);
     g.setColour(juce::Colours::white);
     g.setFont (24.0f);
-    g.drawFittedText("MyDuganPlugin - 4-Channel Automixer", getLocalBounds().reduced(10),
+    g.drawFittedText("MyDuganPlugin - " + juce::String(channelStrips.size()) + "-Channel Automixer", getLocalBounds().reduced(10),
                      juce::Justification::horizontallyCentred | juce::Justification::top, 1);
+
+    // Callback time as a share of the block deadline; an overrun is a likely dropout.
+    g.setFont(12.0f);
+    g.setColour(loadStats.overruns > 0 ? juce::Colours::orange : juce::Colours::grey);
+    g.drawText(juce::String::formatted("DSP load p50 %d%%  p99 %d%%  max %d%%  overruns %llu",
+                                       juce::roundToInt(loadStats.p50 * 100.f),
+                                       juce::roundToInt(loadStats.p99 * 100.f),
+                                       juce::roundToInt(loadStats.max * 100.f),
+                                       (unsigned long long) loadStats.overruns),
+               getLocalBounds().reduced(10).removeFromTop(16), juce::Justification::topLeft);
 }
 
 void MyDuganPluginAudioProcessorEditor::resized()
@@ -66,27 +73,60 @@ void MyDuganPluginAudioProcessorEditor::resized()
     noiseGatePanel.setBounds(topArea.removeFromLeft(panelWidth).reduced(10));
     advancedPanel.setBounds(topArea.reduced(10));
     
-    // Bottom area for channel strips
-    auto channelArea = area;
+    // Bottom area for channel strips: they share the width down to kMinStripWidth,
+    // then the row scrolls
+    stripViewport.setBounds(area);
+    layoutChannelStrips();
+}
+
+void MyDuganPluginAudioProcessorEditor::layoutChannelStrips()
+{
+    auto area = stripViewport.getLocalBounds();
     int numStrips = channelStrips.size();
-    int stripWidth = channelArea.getWidth() / numStrips;
+    int stripWidth = numStrips > 0 ? juce::jmax(kMinStripWidth, area.getWidth() / numStrips) : 0;
+    if (stripWidth * numStrips > area.getWidth())
+        area.removeFromBottom(stripViewport.getScrollBarThickness());
+
+    stripContainer.setSize(juce::jmax(area.getWidth(), stripWidth * numStrips), area.getHeight());
+    auto row = stripContainer.getLocalBounds();
     for (int i = 0; i < numStrips; ++i)
+        channelStrips[i]->setBounds(row.removeFromLeft(stripWidth).reduced(10));
+}
+
+void MyDuganPluginAudioProcessorEditor::updateChannelStrips()
+{
+    // The host may change the layout while the editor is open; rebuild to match.
+    const int numChannels = audioProcessor.getNumMainChannels();
+    if (numChannels == channelStrips.size())
+        return;
+
+    channelStrips.clear();
+    for (int i = 0; i < numChannels; ++i)
     {
-        channelStrips[i]->setBounds(channelArea.removeFromLeft(stripWidth).reduced(10));
+        auto channelName = "Ch " + juce::String(i + 1);
+        auto* strip = new ChannelStripComponent(audioProcessor.parameters, channelName);
+        channelStrips.add(strip);
+        stripContainer.addAndMakeVisible(strip);
     }
+    layoutChannelStrips();
 }
 
 void MyDuganPluginAudioProcessorEditor::timerCallback()
 {
-    // Example: update each strip's RMS and voice active
-    for (int i = 0; i < channelStrips.size(); ++i)
-    {
-        float rmsVal = audioProcessor.agc.getChannelShortTermRMS(i);
-        channelStrips[i]->setRMSLevel(rmsVal);
+    updateChannelStrips();
 
-        bool active = audioProcessor.agc.getChannelAutoGainDb(i) > -20.f;
-        channelStrips[i]->setVoiceActive(active);
+    // Update each strip from the newest meter frame the audio thread published
+    const MeterFrame& meters = audioProcessor.agc.getMeterFrame();
+    const int numMetered = juce::jmin(channelStrips.size(), meters.getNumChannels());
+    for (int i = 0; i < numMetered; ++i)
+    {
+        channelStrips[i]->setRMSLevel(meters.rms[(size_t) i]);
+        channelStrips[i]->setPeakLevel(meters.peak[(size_t) i]);
+        channelStrips[i]->setVoiceActive(meters.gateOpen[(size_t) i] != 0);
+        channelStrips[i]->setLastMic(meters.lastMic[(size_t) i] != 0);
     }
+
+    loadStats = audioProcessor.loadMeter.getStats();
     
     repaint();
 }
@@ -100,6 +100,36 @@ public:
         lookaheadSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 40, 20);
         lookaheadAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
             parameters, "lookahead", lookaheadSlider);
+
+        // Zero latency for IFB feeds: bypasses the lookahead delay
+        addAndMakeVisible(zeroLatencyButton);
+        zeroLatencyButton.setButtonText("Zero latency (IFB)");
+        zeroLatencyAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+            parameters, "zeroLatency", zeroLatencyButton);
+
+        // Sidechain ducking
+        addAndMakeVisible(duckingButton);
+        duckingButton.setButtonText("Duck under sidechain");
+        duckingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+            parameters, "ducking", duckingButton);
+
+        addAndMakeVisible(duckDepthSlider);
+        duckDepthSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+        duckDepthSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 40, 20);
+        duckDepthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            parameters, "duckDepth", duckDepthSlider);
+
+        // Speech gating: only the built-in VAD's talking channels may open
+        addAndMakeVisible(speechGatingButton);
+        speechGatingButton.setButtonText("Gate on speech only (VAD)");
+        speechGatingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+            parameters, "speechGating", speechGatingButton);
+
+        // Cross-talk suppression: mics that only pick up another mic's talker stay shut
+        addAndMakeVisible(crossTalkButton);
+        crossTalkButton.setButtonText("Suppress cross-talk");
+        crossTalkAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+            parameters, "crossTalk", crossTalkButton);
     }
     
     void resized() override
@@ -107,6 +137,11 @@ public:
         auto area = getLocalBounds().reduced(8);
         presetBox.setBounds(area.removeFromTop(30));
         lookaheadSlider.setBounds(area.removeFromTop(40));
+        zeroLatencyButton.setBounds(area.removeFromTop(24));
+        duckingButton.setBounds(area.removeFromTop(24));
+        duckDepthSlider.setBounds(area.removeFromTop(40));
+        speechGatingButton.setBounds(area.removeFromTop(24));
+        crossTalkButton.setBounds(area.removeFromTop(24));
     }
 
 private:
@@ -116,6 +151,21 @@ private:
     
     juce::Slider lookaheadSlider;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> lookaheadAttachment;
+
+    juce::ToggleButton zeroLatencyButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> zeroLatencyAttachment;
+
+    juce::ToggleButton duckingButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> duckingAttachment;
+
+    juce::Slider duckDepthSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> duckDepthAttachment;
+
+    juce::ToggleButton speechGatingButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> speechGatingAttachment;
+
+    juce::ToggleButton crossTalkButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> crossTalkAttachment;
 };
 
 class MyDuganPluginAudioProcessorEditor : public juce::AudioProcessorEditor,
@@ -130,14 +180,21 @@ public:
 
 private:
     void timerCallback() override;
+
+    // One strip per processor input; rebuilt when the bus layout changes.
+    void updateChannelStrips();
+    void layoutChannelStrips();
+    static constexpr int kMinStripWidth = 90;
     
     MyDuganPluginAudioProcessor& audioProcessor;
     
     // Custom LookAndFeel instance
     MyCustomLookAndFeel customLF;
     
-    // Example: 4 channel strips
+    // Channel strips, inside a scrolling row for large rooms
     juce::OwnedArray<ChannelStripComponent> channelStrips;
+    juce::Component stripContainer;
+    juce::Viewport stripViewport;
     
     // Panels
     AutomixerPanel automixerPanel;
@@ -147,6 +204,9 @@ private:
     // Master gain slider
     juce::Slider masterGainSlider;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> masterGainAttachment;
+
+    // Latest DSP load snapshot, refreshed by the timer
+    DspLoadMeter::Stats loadStats;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MyDuganPluginAudioProcessorEditor)
 };
@@ -1,71 +1,198 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 #include "ChannelStripComponent.h"
+#include "RealtimeSafety.h"
+#include "SidechainDetector.h"
+#include "DspVoiceActivityDetector.h"
 
-static constexpr int kMainChannels = 4; // 4 mono tracks
+static constexpr int kDefaultMainChannels = 4; // 4 mono tracks until the host negotiates a layout
+static constexpr int kMaxSidechainChannels = SidechainDetector::kMaxChannels;
+static_assert(MyDuganPluginAudioProcessor::kMaxMainChannels <= MeterFrame::kMaxChannels,
+              "every main input needs a meter slot");
+
+static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout
+    {
+        // [Parameter definitions go here...]
+        // For example:
+        std::make_unique<juce::AudioParameterFloat>("gateThreshold", "Gate Threshold (dB)", -60.f, 0.f, -40.f),
+        std::make_unique<juce::AudioParameterFloat>("lookahead", "Lookahead (ms)",
+                                                    0.f, EnhancedDuganAGC::kMaxLookaheadMs, 5.f),
+        std::make_unique<juce::AudioParameterBool>("zeroLatency", "Zero Latency (IFB)", false),
+        std::make_unique<juce::AudioParameterBool>("ducking", "Sidechain Ducking", false),
+        std::make_unique<juce::AudioParameterFloat>("duckDepth", "Duck Depth (dB)", 0.f, 24.f, 12.f),
+        std::make_unique<juce::AudioParameterBool>("speechGating", "Speech Gating (VAD)", false),
+        std::make_unique<juce::AudioParameterBool>("crossTalk", "Cross-talk Suppression", false),
+        // ... (all the rest of your parameter definitions) ...
+    };
+
+    // Stereo position of each input, -1 (left) to +1 (right). Parameters can't come
+    // and go with the bus layout, so there is one per possible input.
+    for (int ch = 1; ch <= MyDuganPluginAudioProcessor::kMaxMainChannels; ++ch)
+        layout.add(std::make_unique<juce::AudioParameterFloat>("pan" + juce::String(ch), "Ch " + juce::String(ch) + " Pan",
+                                                               -1.f, 1.f, 0.f));
+    return layout;
+}
 
 // Constructor
 MyDuganPluginAudioProcessor::MyDuganPluginAudioProcessor()
   : AudioProcessor (BusesProperties()
-      // One input bus: a discrete set of 4 mono channels.
-      .withInput("Inputs", juce::AudioChannelSet::discreteChannels(kMainChannels), true)
+      // One input bus: a discrete set of mono channels, kMinMainChannels to kMaxMainChannels.
+      .withInput("Inputs", juce::AudioChannelSet::discreteChannels(kDefaultMainChannels), true)
+      // Optional sidechain (programme/playback) for ducking, off by default.
+      .withInput("Sidechain", juce::AudioChannelSet::mono(), false)
       // One output bus: stereo output.
       .withOutput("MainOut", juce::AudioChannelSet::stereo(), true)
     ),
-    parameters(*this, nullptr, "PARAMS",
-    {
-        // [Parameter definitions go here...]
-        // For example:
-        std::make_unique<juce::AudioParameterFloat>("gateThreshold", "Gate Threshold (dB)", -60.f, 0.f, -40.f),
-        // ... (all the rest of your parameter definitions) ...
-    })
+    parameters(*this, nullptr, "PARAMS", createParameterLayout())
 {
-    // Constructor implementation (if any)
+    // Until prepareToPlay(), the editor shows the default layout.
+    mainChannels.store(getMainBusNumInputChannels());
+
+    for (int ch = 0; ch < kMaxMainChannels; ++ch)
+        panParameters[(size_t) ch] = parameters.getRawParameterValue("pan" + juce::String(ch + 1));
+    appliedPan.fill(-2.f); // out of range, so the first timer tick sends every pan
+
+    // Latency changes come from the message thread, so poll the two parameters
+    // that affect it here rather than from the audio callback.
+    startTimerHz(20);
 }
 
 // Destructor (must be defined, even if empty)
 MyDuganPluginAudioProcessor::~MyDuganPluginAudioProcessor()
 {
-    // Empty destructor is fine.
+    stopTimer();
 }
 
 // prepareToPlay
 void MyDuganPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    agc.prepare(sampleRate, samplesPerBlock, kMainChannels, 0); // 0 sidechain channels for now
+    // Settings go to the engine straight from the parameters: the applied* values
+    // belong to the timer, which may be running on another thread.
+    agc.setLookaheadMs(parameters.getRawParameterValue("lookahead")->load());
+    agc.setZeroLatency(parameters.getRawParameterValue("zeroLatency")->load() >= 0.5f);
+    agc.setDuckingEnabled(parameters.getRawParameterValue("ducking")->load() >= 0.5f);
+    agc.setDuckDepthDb(parameters.getRawParameterValue("duckDepth")->load());
+    agc.setUseMLSpeechDetection(parameters.getRawParameterValue("speechGating")->load() >= 0.5f);
+    agc.setCrossTalkSuppression(parameters.getRawParameterValue("crossTalk")->load() >= 0.5f);
+
+    // Everything per channel is sized from the negotiated layout; the engine's
+    // per-block work is linear in this count.
+    const int numInputs = getMainBusNumInputChannels();
+
+    // The built-in VAD; its state is sized for this rate and channel count.
+    agc.setSpeechDetector(std::make_shared<DspVoiceActivityDetector>(sampleRate, numInputs));
+
+    auto* sideBus = getBusCount(true) > 1 ? getBus(true, 1) : nullptr;
+    sideChannels = sideBus != nullptr && sideBus->isEnabled() ? sideBus->getNumberOfChannels() : 0;
+    agc.prepare(sampleRate, samplesPerBlock, numInputs, sideChannels, getMainBusNumOutputChannels());
+    mainChannels.store(numInputs);
+    loadMeter.prepare(sampleRate);
+
+    // The output matrix is sized by prepare(), so the pans go in after it, also
+    // straight from the parameters.
+    for (int ch = 0; ch < numInputs; ++ch)
+        agc.setChannelPan(ch, panParameters[(size_t) ch]->load());
+    setLatencySamples(agc.getLatencySamples());
+}
+
+double MyDuganPluginAudioProcessor::getTailLengthSeconds() const
+{
+    // The lookahead delay keeps producing output after the input stops.
+    return getSampleRate() > 0.0 ? getLatencySamples() / getSampleRate() : 0.0;
+}
+
+void MyDuganPluginAudioProcessor::timerCallback()
+{
+    updateLatencySettings();
+    updateDuckingSettings();
+    updateGatingSettings();
+    updatePanSettings();
+}
+
+void MyDuganPluginAudioProcessor::updateLatencySettings()
+{
+    const float lookaheadMs = parameters.getRawParameterValue("lookahead")->load();
+    const bool zeroLatency = parameters.getRawParameterValue("zeroLatency")->load() >= 0.5f;
+    if (lookaheadMs == appliedLookaheadMs && zeroLatency == appliedZeroLatency)
+        return;
+
+    appliedLookaheadMs = lookaheadMs;
+    appliedZeroLatency = zeroLatency;
+    agc.setLookaheadMs(lookaheadMs);
+    agc.setZeroLatency(zeroLatency);
+
+    // The engine crossfades to the new delay; the host re-aligns on the new latency.
+    if (getSampleRate() > 0.0)
+        setLatencySamples(agc.getLatencySamples());
+}
+
+void MyDuganPluginAudioProcessor::updateDuckingSettings()
+{
+    const bool ducking = parameters.getRawParameterValue("ducking")->load() >= 0.5f;
+    const float depthDb = parameters.getRawParameterValue("duckDepth")->load();
+    if (ducking == appliedDucking && depthDb == appliedDuckDepthDb)
+        return;
+
+    appliedDucking = ducking;
+    appliedDuckDepthDb = depthDb;
+    agc.setDuckingEnabled(ducking);
+    agc.setDuckDepthDb(depthDb);
+}
+
+void MyDuganPluginAudioProcessor::updateGatingSettings()
+{
+    const bool speechGating = parameters.getRawParameterValue("speechGating")->load() >= 0.5f;
+    const bool crossTalk = parameters.getRawParameterValue("crossTalk")->load() >= 0.5f;
+    if (speechGating == appliedSpeechGating && crossTalk == appliedCrossTalk)
+        return;
+
+    appliedSpeechGating = speechGating;
+    appliedCrossTalk = crossTalk;
+    agc.setUseMLSpeechDetection(speechGating);
+    agc.setCrossTalkSuppression(crossTalk);
+}
+
+void MyDuganPluginAudioProcessor::updatePanSettings()
+{
+    const int numInputs = mainChannels.load();
+    for (int ch = 0; ch < numInputs; ++ch)
+    {
+        const float pan = panParameters[(size_t) ch]->load();
+        if (pan != appliedPan[(size_t) ch])
+        {
+            appliedPan[(size_t) ch] = pan;
+            agc.setChannelPan(ch, pan);
+        }
+    }
 }
 
 // processBlock
 void MyDuganPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
 {
     juce::ignoreUnused(midi);
+    RealtimeSafety::ScopedNoAllocation noAlloc;
     
     int nSamples = buffer.getNumSamples();
-    auto* channelData = buffer.getArrayOfWritePointers();
+    DspLoadMeter::ScopedBlock timing(loadMeter, nSamples);
+    const int numInputs = mainChannels.load(std::memory_order_relaxed);
+    jassert (buffer.getNumChannels() >= numInputs);
 
-    // Build an array of pointers for the 4 channels:
-    std::vector<float*> channels;
-    for (int ch = 0; ch < kMainChannels; ++ch)
-    {
-        channels.push_back(channelData[ch]);
-    }
+    // The buffer's own pointer array already holds the input channels first:
+    auto* channels = buffer.getArrayOfWritePointers();
 
-    // Process the block using our automixer:
-    agc.processBlock(channels.data(), kMainChannels, nSamples, nullptr, 0, 0);
+    // Sidechain channels follow the main inputs in the process buffer:
+    float** side = nullptr;
+    if (sideChannels > 0)
+        side = channels + getChannelIndexInProcessBlockBuffer(true, 1, 0);
 
-    // Mix the channels into a stereo output:
+    // Automix, pan and sum into the stereo output in one pass. The outputs share
+    // storage with inputs 0 and 1; the engine only writes them once every input
+    // has been read.
     auto outBus = getBusBuffer(buffer, false, 0);
-    float* outL = outBus.getWritePointer(0);
-    float* outR = outBus.getWritePointer(1);
-
-    for (int i = 0; i < nSamples; ++i)
-    {
-        float mix = 0.f;
-        for (int ch = 0; ch < kMainChannels; ++ch)
-            mix += channels[ch][i];
-        outL[i] = mix;
-        outR[i] = mix;
-    }
+    agc.processBlock(channels, numInputs, nSamples, side, sideChannels, nSamples,
+                     outBus.getArrayOfWritePointers(), outBus.getNumChannels());
 }
 
 // createEditor: Return a pointer to your editor.
@@ -98,14 +225,23 @@ void MyDuganPluginAudioProcessor::setStateInformation(const void* data, int size
 // isBusesLayoutSupported: Check if the given layout is acceptable.
 bool MyDuganPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
 {
-    // Check the input bus: it must be a discrete set of 4 channels.
+    // Check the input bus: kMinMainChannels to kMaxMainChannels. Every channel is one
+    // mic, so a named layout (stereo, 5.1, ...) is taken as that many mics.
     if (layouts.inputBuses.size() > 0)
     {
         auto inputSet = layouts.getChannelSet(true, 0);
-        if (inputSet != juce::AudioChannelSet::discreteChannels(kMainChannels))
+        if (inputSet.size() < kMinMainChannels || inputSet.size() > kMaxMainChannels)
             return false;
     }
     
+    // The sidechain may be disabled, or 1 to 8 channels.
+    if (layouts.inputBuses.size() > 1)
+    {
+        auto sideSet = layouts.getChannelSet(true, 1);
+        if (! sideSet.isDisabled() && sideSet.size() > kMaxSidechainChannels)
+            return false;
+    }
+
     // Check the output bus: it must be stereo.
     if (layouts.outputBuses.size() > 0)
     {
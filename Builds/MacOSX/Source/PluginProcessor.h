@@ -1,16 +1,28 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <array>
+#include "DspLoadMeter.h"
 #include "EnhancedDuganAGC.h"
 
 /**
     MyDuganPluginAudioProcessor:
-    - A bus plugin that accepts 4 mono inputs.
-    - Implements a Dugan-inspired gain-sharing algorithm (via EnhancedDuganAGC) to mix the 4 channels.
+    - A bus plugin that accepts 2 to 64 mono inputs (4 by default). The engine,
+      VAD and meters are sized from the layout the host settles on, in
+      prepareToPlay().
+    - An optional sidechain bus (1 to 8 channels) drives the adaptive threshold
+      and ducks the whole automix under programme/playback audio.
+    - Implements a Dugan-inspired gain-sharing algorithm (via EnhancedDuganAGC) to mix the channels.
+    - Each input has a pan parameter; the engine applies the automix gains and
+      pans the channels into the stereo output in a single pass.
 */
-class MyDuganPluginAudioProcessor : public juce::AudioProcessor
+class MyDuganPluginAudioProcessor : public juce::AudioProcessor,
+                                    private juce::Timer
 {
 public:
+    static constexpr int kMinMainChannels = 2;
+    static constexpr int kMaxMainChannels = 64;
+
     MyDuganPluginAudioProcessor();
     ~MyDuganPluginAudioProcessor() override;
 
@@ -28,7 +40,7 @@ public:
     const juce::String getName() const override               { return "MyDuganPlugin"; }
     bool acceptsMidi() const override                         { return false; }
     bool producesMidi() const override                        { return false; }
-    double getTailLengthSeconds() const override              { return 0.0; }
+    double getTailLengthSeconds() const override;
 
     //==============================================================================
     int getNumPrograms() override                             { return 1; }
@@ -44,9 +56,42 @@ public:
     // Our parameter tree
     juce::AudioProcessorValueTreeState parameters;
 
-    // Our enhanced automixer (now configured for 4 channels)
+    // Our enhanced automixer, prepared for getNumMainChannels() inputs
     EnhancedDuganAGC agc;
 
+    // Inputs the engine was last prepared for; the editor shows one strip per input.
+    int getNumMainChannels() const { return mainChannels.load(); }
+
+    // Time spent in processBlock() against each block's deadline; read by the editor.
+    DspLoadMeter loadMeter;
+
 private:
+    // Pushes lookahead/zero-latency changes to the engine and reports the new latency,
+    // and forwards the ducking, speech-gating, cross-talk and pan settings. The
+    // applied* members below are the timer's own: prepareToPlay() may run on another
+    // thread, so it sends its settings straight from the parameters instead.
+    void timerCallback() override;
+    void updateLatencySettings();
+    void updateDuckingSettings();
+    void updateGatingSettings();
+    void updatePanSettings();
+
+    float appliedLookaheadMs = -1.f;
+    bool appliedZeroLatency = false;
+    float appliedDuckDepthDb = -1.f;
+    bool appliedDucking = false;
+    bool appliedSpeechGating = false;
+    bool appliedCrossTalk = false;
+
+    // "pan1".."pan64", looked up once in the constructor, and the value each input's
+    // pan was last sent to the engine with. Both are fixed size, so a layout change
+    // never resizes what the timer iterates.
+    std::array<std::atomic<float>*, kMaxMainChannels> panParameters {};
+    std::array<float, kMaxMainChannels> appliedPan {};
+
+    // Main and sidechain channels in the current layout (sidechain 0 when the bus is disabled)
+    std::atomic<int> mainChannels { 0 };
+    int sideChannels = 0;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MyDuganPluginAudioProcessor)
 };
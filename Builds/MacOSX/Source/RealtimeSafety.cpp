@@ -0,0 +1,236 @@
+// RealtimeSafety.cpp
+#include "RealtimeSafety.h"
+
+#if MDP_ASSERT_NO_AUDIO_ALLOCATIONS || MDP_REALTIME_CHECKER
+
+#include <cassert>
+#include <cstdlib>
+#include <new>
+
+int& RealtimeSafety::noAllocationDepth() noexcept
+{
+    static thread_local int depth = 0;
+    return depth;
+}
+
+#endif
+
+#if MDP_REALTIME_CHECKER
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+
+#if defined(__GLIBC__)
+ #define MDP_CHECK_LIBC 1
+ #include <dlfcn.h>
+ #include <pthread.h>
+
+extern "C"
+{
+    void* __libc_malloc(std::size_t);
+    void* __libc_calloc(std::size_t, std::size_t);
+    void* __libc_realloc(void*, std::size_t);
+    void* __libc_memalign(std::size_t, std::size_t);
+    void  __libc_free(void*);
+}
+#else
+ #define MDP_CHECK_LIBC 0
+#endif
+
+#if __has_include(<execinfo.h>)
+ #include <execinfo.h>
+ #define MDP_CHECK_BACKTRACE 1
+#else
+ #define MDP_CHECK_BACKTRACE 0
+#endif
+
+namespace
+{
+    std::atomic<int> violations { 0 };
+    std::atomic<bool> abortOnViolation { true };
+
+    // Set while a violation is reported, so the report's own calls aren't checked.
+    thread_local bool reporting = false;
+
+   #if MDP_CHECK_BACKTRACE
+    // backtrace() loads its unwinder, and allocates, the first time it runs.
+    [[maybe_unused]] const bool unwinderLoaded = [] { void* frame[1]; return backtrace(frame, 1) >= 0; }();
+   #endif
+
+    void reportViolation(const char* what) noexcept
+    {
+        reporting = true;
+        violations.fetch_add(1, std::memory_order_relaxed);
+        std::fprintf(stderr, "realtime violation: %s inside RealtimeSafety::ScopedNoAllocation\n", what);
+
+       #if MDP_CHECK_BACKTRACE
+        void* frames[48];
+        const int n = backtrace(frames, 48);
+        backtrace_symbols_fd(frames + 1, n - 1, 2); // without this frame
+       #endif
+        std::fflush(stderr);
+        reporting = false;
+
+        if (abortOnViolation.load(std::memory_order_relaxed))
+            std::abort();
+    }
+
+    inline void check(const char* what) noexcept
+    {
+        if (RealtimeSafety::noAllocationDepth() > 0 && !reporting)
+            reportViolation(what);
+    }
+
+    inline void* rawAllocate(std::size_t size) noexcept
+    {
+       #if MDP_CHECK_LIBC
+        return __libc_malloc(size);
+       #else
+        return std::malloc(size);
+       #endif
+    }
+
+    inline void rawFree(void* p) noexcept
+    {
+       #if MDP_CHECK_LIBC
+        __libc_free(p);
+       #else
+        std::free(p);
+       #endif
+    }
+
+    void* checkedNew(std::size_t size, const char* what)
+    {
+        check(what);
+        if (void* p = rawAllocate(size == 0 ? 1 : size))
+            return p;
+        throw std::bad_alloc();
+    }
+
+    void checkedDelete(void* p, const char* what) noexcept
+    {
+        if (p != nullptr)
+            check(what);
+        rawFree(p);
+    }
+}
+
+void RealtimeSafety::setAbortOnViolation(bool shouldAbort) noexcept
+{
+    abortOnViolation.store(shouldAbort, std::memory_order_relaxed);
+}
+
+int RealtimeSafety::getViolationCount() noexcept
+{
+    return violations.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)                                   { return checkedNew(size, "operator new"); }
+void* operator new[](std::size_t size)                                 { return checkedNew(size, "operator new[]"); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return checkedNew(size, "operator new"); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return checkedNew(size, "operator new[]"); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept                                 { checkedDelete(p, "operator delete"); }
+void operator delete[](void* p) noexcept                               { checkedDelete(p, "operator delete[]"); }
+void operator delete(void* p, std::size_t) noexcept                    { checkedDelete(p, "operator delete"); }
+void operator delete[](void* p, std::size_t) noexcept                  { checkedDelete(p, "operator delete[]"); }
+void operator delete(void* p, const std::nothrow_t&) noexcept          { checkedDelete(p, "operator delete"); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept        { checkedDelete(p, "operator delete[]"); }
+
+#if MDP_CHECK_LIBC
+
+// The C allocator and blocking pthread calls, replaced for the whole process.
+extern "C"
+{
+    void* malloc(std::size_t size) noexcept                 { check("malloc"); return __libc_malloc(size); }
+    void* calloc(std::size_t n, std::size_t size) noexcept  { check("calloc"); return __libc_calloc(n, size); }
+    void* realloc(void* p, std::size_t size) noexcept       { check("realloc"); return __libc_realloc(p, size); }
+    void* memalign(std::size_t align, std::size_t size) noexcept      { check("memalign"); return __libc_memalign(align, size); }
+    void* aligned_alloc(std::size_t align, std::size_t size) noexcept { check("aligned_alloc"); return __libc_memalign(align, size); }
+
+    int posix_memalign(void** out, std::size_t align, std::size_t size) noexcept
+    {
+        check("posix_memalign");
+        if (align % sizeof(void*) != 0 || (align & (align - 1)) != 0)
+            return EINVAL;
+        void* p = __libc_memalign(align, size);
+        if (p == nullptr)
+            return ENOMEM;
+        *out = p;
+        return 0;
+    }
+
+    void free(void* p) noexcept
+    {
+        if (p != nullptr)
+            check("free");
+        __libc_free(p);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* m) noexcept
+    {
+        static const auto next = reinterpret_cast<int (*)(pthread_mutex_t*)>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        check("pthread_mutex_lock (std::mutex::lock)");
+        return next(m);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* l) noexcept
+    {
+        static const auto next = reinterpret_cast<int (*)(pthread_rwlock_t*)>(dlsym(RTLD_NEXT, "pthread_rwlock_rdlock"));
+        check("pthread_rwlock_rdlock (std::shared_mutex::lock_shared)");
+        return next(l);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t* l) noexcept
+    {
+        static const auto next = reinterpret_cast<int (*)(pthread_rwlock_t*)>(dlsym(RTLD_NEXT, "pthread_rwlock_wrlock"));
+        check("pthread_rwlock_wrlock (std::shared_mutex::lock)");
+        return next(l);
+    }
+}
+
+#endif // MDP_CHECK_LIBC
+
+#elif MDP_ASSERT_NO_AUDIO_ALLOCATIONS
+
+namespace
+{
+    void* checkedAllocate(std::size_t size)
+    {
+        assert(RealtimeSafety::noAllocationDepth() == 0
+               && "heap allocation on the audio thread after prepare()");
+
+        if (size == 0)
+            size = 1;
+        if (void* p = std::malloc(size))
+            return p;
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t size)                                   { return checkedAllocate(size); }
+void* operator new[](std::size_t size)                                 { return checkedAllocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return checkedAllocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return checkedAllocate(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept                                 { std::free(p); }
+void operator delete[](void* p) noexcept                               { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept                    { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept                  { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept          { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept        { std::free(p); }
+
+#endif
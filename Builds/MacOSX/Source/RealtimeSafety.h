@@ -0,0 +1,67 @@
+// RealtimeSafety.h
+#pragma once
+
+/**
+    Debug-only guard against heap allocation on the audio thread.
+
+    Put a ScopedNoAllocation at the top of any processBlock(). While one is alive
+    on the current thread, the global operator new replacement in RealtimeSafety.cpp
+    asserts, so an allocation sneaking into the hot path after prepare() fails
+    loudly in debug builds instead of showing up as a dropout on a live rig.
+
+    Enabled when MDP_ASSERT_NO_AUDIO_ALLOCATIONS is non-zero (defaults to on
+    whenever NDEBUG is not defined). In release builds the guard compiles away.
+
+    Realtime checker (MDP_REALTIME_CHECKER=1, off by default):
+    - A stricter mode for test and benchmark executables, independent of NDEBUG.
+      Inside a ScopedNoAllocation it catches operator new/delete and, on glibc,
+      malloc/calloc/realloc/free/aligned allocations and blocking pthread calls
+      (mutex and rwlock locks, condition waits), which covers std::mutex.
+      Non-blocking calls such as try-locks and semaphore posts are allowed.
+    - Each violation prints what happened and a backtrace to stderr, then aborts
+      (or, after setAbortOnViolation(false), is only counted).
+    - It replaces malloc and pthread symbols process-wide, so only link it into
+      executables (Benchmarks: -DMDP_REALTIME_CHECK=ON), never into the plugin.
+      Elsewhere than glibc only operator new/delete are checked.
+*/
+#ifndef MDP_ASSERT_NO_AUDIO_ALLOCATIONS
+ #ifdef NDEBUG
+  #define MDP_ASSERT_NO_AUDIO_ALLOCATIONS 0
+ #else
+  #define MDP_ASSERT_NO_AUDIO_ALLOCATIONS 1
+ #endif
+#endif
+
+#ifndef MDP_REALTIME_CHECKER
+ #define MDP_REALTIME_CHECKER 0
+#endif
+
+namespace RealtimeSafety
+{
+#if MDP_ASSERT_NO_AUDIO_ALLOCATIONS || MDP_REALTIME_CHECKER
+    // Nesting depth of ScopedNoAllocation on the calling thread.
+    int& noAllocationDepth() noexcept;
+
+    struct ScopedNoAllocation
+    {
+        ScopedNoAllocation() noexcept  { ++noAllocationDepth(); }
+        ~ScopedNoAllocation() noexcept { --noAllocationDepth(); }
+
+        ScopedNoAllocation(const ScopedNoAllocation&) = delete;
+        ScopedNoAllocation& operator=(const ScopedNoAllocation&) = delete;
+    };
+#else
+    struct ScopedNoAllocation
+    {
+        ScopedNoAllocation() noexcept {}
+    };
+#endif
+
+#if MDP_REALTIME_CHECKER
+    // Abort on the first violation (default), or only count and report them.
+    void setAbortOnViolation(bool shouldAbort) noexcept;
+
+    // Violations seen so far, on any thread.
+    int getViolationCount() noexcept;
+#endif
+}
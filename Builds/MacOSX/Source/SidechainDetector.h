@@ -0,0 +1,62 @@
+// SidechainDetector.h
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include "VectorKernels.h"
+
+/**
+    SidechainDetector:
+    - Level of a sidechain bus of up to kMaxChannels channels, measured over
+      the engine's control blocks: the RMS of the loudest channel.
+    - Each channel's sum of squares goes through the SIMD sumSquares kernel; a
+      window may be fed in several pieces when a host block boundary splits it.
+      The RMS is over the samples actually fed, so a sidechain block shorter
+      than the main block doesn't read as quieter than it is; a window fed no
+      samples at all repeats the previous level.
+    - Taking the max of per-channel RMS (rather than summing channels) keeps
+      the level independent of how many channels carry the same programme.
+*/
+class SidechainDetector
+{
+public:
+    static constexpr int kMaxChannels = 8;
+
+    void reset()
+    {
+        sums.fill(0.f);
+        windowLength = 0;
+        level = 0.f;
+    }
+
+    // Adds samples [offset, offset + n) of each channel to the current window.
+    void accumulate(const VectorKernels& kernels, const float* const* data, int numChannels, int offset, int n)
+    {
+        if (n <= 0)
+            return;
+        numChannels = std::min(numChannels, kMaxChannels);
+        for (int ch = 0; ch < numChannels; ++ch)
+            sums[static_cast<size_t>(ch)] += kernels.sumSquares(data[ch] + offset, n);
+        windowLength += n;
+    }
+
+    // Ends the window: the loudest channel's RMS over the samples fed to it, or the
+    // previous window's level if none were. Starts a new window.
+    float takeLevel()
+    {
+        if (windowLength > 0)
+        {
+            const float loudest = *std::max_element(sums.begin(), sums.end());
+            level = std::sqrt(loudest / static_cast<float>(windowLength));
+            sums.fill(0.f);
+            windowLength = 0;
+        }
+        return level;
+    }
+
+private:
+    std::array<float, kMaxChannels> sums {};
+    int windowLength = 0;   // samples accumulated into sums
+    float level = 0.f;      // the last window's level
+};
@@ -0,0 +1,113 @@
+// SpeechAnalysisThread.cpp
+#include "SpeechAnalysisThread.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+SpeechAnalysisThread::SpeechAnalysisThread() = default;
+
+SpeechAnalysisThread::~SpeechAnalysisThread()
+{
+    stop();
+}
+
+void SpeechAnalysisThread::start(std::shared_ptr<MLSpeechDetector> newDetector, int numChannels, int newFrameSize)
+{
+    stop();
+
+    detector = std::move(newDetector);
+    numChans = std::max(0, numChannels);
+    frameSize = std::max(1, newFrameSize);
+    if (detector == nullptr || numChans == 0)
+        return;
+
+    slots.assign(static_cast<size_t>(kNumSlots) * static_cast<size_t>(numChans) * static_cast<size_t>(frameSize), 0.f);
+    freeSlots = std::make_unique<LockFreeFifo<int>>(kNumSlots);
+    frames = std::make_unique<LockFreeFifo<FrameTicket>>(kNumSlots);
+    results = std::make_unique<LockFreeFifo<SpeechResult>>(static_cast<size_t>(numChans) * kNumSlots * 2);
+    for (int slot = 0; slot < kNumSlots; ++slot)
+        freeSlots->push(slot);
+    framePointers.assign(static_cast<size_t>(numChans), nullptr);
+    probabilities.assign(static_cast<size_t>(numChans), 0.f);
+    frameResults.assign(static_cast<size_t>(numChans), SpeechResult());
+
+    fillSlot = -1;
+    fillPosition = 0;
+    droppedFrames.store(0, std::memory_order_relaxed);
+    quit.store(false, std::memory_order_relaxed);
+    thread = std::thread([this] { run(); });
+}
+
+void SpeechAnalysisThread::stop()
+{
+    if (thread.joinable())
+    {
+        quit.store(true, std::memory_order_relaxed);
+        thread.join();
+    }
+}
+
+void SpeechAnalysisThread::pushAudio(const float* const* data, int offset, int numSamples, std::int64_t streamPosition)
+{
+    if (!isRunning())
+        return;
+
+    for (int pos = 0; pos < numSamples;)
+    {
+        // A frame takes a slot when it starts; with none free, the whole frame is skipped.
+        if (fillPosition == 0 && !freeSlots->pop(fillSlot))
+            fillSlot = -1;
+
+        const int len = std::min(numSamples - pos, frameSize - fillPosition);
+        if (fillSlot >= 0)
+        {
+            for (int ch = 0; ch < numChans; ++ch)
+                std::memcpy(slotData(fillSlot, ch) + fillPosition, data[ch] + offset + pos, sizeof(float) * static_cast<size_t>(len));
+        }
+        pos += len;
+        fillPosition += len;
+
+        if (fillPosition == frameSize)
+        {
+            // Cannot fail: there are never more tickets than slots.
+            if (fillSlot >= 0)
+                frames->push({ fillSlot, streamPosition + pos });
+            else
+                droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            fillSlot = -1;
+            fillPosition = 0;
+        }
+    }
+}
+
+void SpeechAnalysisThread::run()
+{
+    while (!quit.load(std::memory_order_relaxed))
+    {
+        FrameTicket ticket;
+        if (!frames->pop(ticket))
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(kPollIntervalUs));
+            continue;
+        }
+
+        for (int ch = 0; ch < numChans; ++ch)
+            framePointers[static_cast<size_t>(ch)] = slotData(ticket.slot, ch);
+        detector->detectSpeechBatch(framePointers.data(), numChans, frameSize, probabilities.data());
+
+        for (int ch = 0; ch < numChans; ++ch)
+        {
+            auto& result = frameResults[static_cast<size_t>(ch)];
+            result.channel = ch;
+            result.probability = probabilities[static_cast<size_t>(ch)];
+            result.isActive = result.probability > MLSpeechDetector::kSpeechThreshold;
+            result.frameEnd = ticket.frameEnd;
+        }
+
+        // The whole frame in one index update. If the audio thread hasn't collected
+        // earlier results, whatever doesn't fit is lost; it only keeps the latest
+        // per channel anyway.
+        results->pushN(frameResults.data(), frameResults.size());
+        freeSlots->push(ticket.slot);
+    }
+}
@@ -0,0 +1,95 @@
+// SpeechAnalysisThread.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "LockFreeFifo.h"
+#include "MLSpeechDetector.h"
+
+// One channel's speech decision for one analysis frame.
+struct SpeechResult
+{
+    int channel = 0;
+    bool isActive = false;
+    float probability = 0.f;   // the detector's confidence, 0..1
+    std::int64_t frameEnd = 0; // stream position (samples) just after the analysed frame
+};
+
+/**
+    SpeechAnalysisThread:
+    - Runs an MLSpeechDetector off the audio thread. The audio thread cuts its
+      input into fixed frames; a background thread classifies all channels of
+      each frame in one detectSpeechBatch() call and sends back one
+      SpeechResult per channel.
+    - Frames are assembled straight into a pool of preallocated slots. Slot
+      indices travel to the analysis thread through one LockFreeFifo and back
+      through another, so the audio side never copies a frame twice, never
+      allocates and never waits.
+    - If the detector falls behind and no slot is free, the audio thread skips
+      that frame (counted in getDroppedFrames()); results carry the stream
+      position of their frame, so later ones are still placed correctly.
+    - The analysis thread polls every kPollIntervalUs when idle. Decision
+      latency is therefore at most one frame, plus the poll interval, plus the
+      detector's own time per frame. mdp_speech_latency_bench measures it.
+*/
+class SpeechAnalysisThread
+{
+public:
+    static constexpr int kPollIntervalUs = 500;
+
+    SpeechAnalysisThread();
+    ~SpeechAnalysisThread();
+
+    // Message thread. Stops any running analysis and starts a new one.
+    void start(std::shared_ptr<MLSpeechDetector> detector, int numChannels, int frameSize);
+    void stop();
+
+    bool isRunning() const { return thread.joinable(); }
+    int getFrameSize() const { return frameSize; }
+
+    // Audio thread. Queues samples [offset, offset + numSamples) of every channel;
+    // streamPosition is the position of sample `offset` in the stream.
+    void pushAudio(const float* const* data, int offset, int numSamples, std::int64_t streamPosition);
+
+    // Audio thread. The oldest result not yet collected.
+    bool popResult(SpeechResult& result) { return results != nullptr && results->pop(result); }
+
+    std::uint64_t getDroppedFrames() const { return droppedFrames.load(std::memory_order_relaxed); }
+
+private:
+    struct FrameTicket
+    {
+        int slot = 0;
+        std::int64_t frameEnd = 0;
+    };
+
+    static constexpr int kNumSlots = 8;
+
+    void run();
+    float* slotData(int slot, int ch) { return slots.data() + (static_cast<size_t>(slot) * numChans + ch) * frameSize; }
+
+    std::shared_ptr<MLSpeechDetector> detector;
+    int numChans = 0;
+    int frameSize = 0;
+
+    std::vector<float> slots;
+    std::unique_ptr<LockFreeFifo<int>> freeSlots;
+    std::unique_ptr<LockFreeFifo<FrameTicket>> frames;
+    std::unique_ptr<LockFreeFifo<SpeechResult>> results;
+
+    // Analysis-thread scratch, sized in start().
+    std::vector<const float*> framePointers;
+    std::vector<float> probabilities;
+    std::vector<SpeechResult> frameResults;
+
+    // Audio-thread state: the slot being filled (-1 = skipping this frame) and how far.
+    int fillSlot = -1;
+    int fillPosition = 0;
+
+    std::atomic<std::uint64_t> droppedFrames {0};
+    std::atomic<bool> quit {false};
+    std::thread thread;
+};
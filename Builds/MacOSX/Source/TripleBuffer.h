@@ -0,0 +1,57 @@
+// TripleBuffer.h
+#pragma once
+
+#include <atomic>
+
+/**
+    TripleBuffer:
+    - Hands the latest value of a T from one writer thread to one reader thread
+      with no locks and no allocation on either side.
+    - The writer fills getWriteBuffer() and calls publish(). The reader calls
+      read(), which costs one acquire load when nothing changed and one exchange
+      when something did. Intermediate values the reader never saw are skipped.
+    - Three slots: the reader's, the writer's, and the last published one. The
+      slots swap by index only; T is never copied here.
+    - Exactly one writer and one reader at a time. Several writer threads must
+      serialise among themselves (the engines use a mutex off the audio thread).
+*/
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Writer side: the slot to fill before publish(). It may hold any older value.
+    T& getWriteBuffer() { return slots[backIndex]; }
+
+    void publish()
+    {
+        backIndex = state.exchange(backIndex | kNewBit, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // Reader side: the most recently published value.
+    const T& read()
+    {
+        if (state.load(std::memory_order_acquire) & kNewBit)
+            frontIndex = state.exchange(frontIndex, std::memory_order_acq_rel) & kIndexMask;
+        return slots[frontIndex];
+    }
+
+    // Only while neither side is running (e.g. in prepare()): set every slot to value.
+    template <typename U>
+    void reset(const U& value)
+    {
+        for (auto& s : slots)
+            s = value;
+        backIndex = 0;
+        frontIndex = 1;
+        state.store(2, std::memory_order_release);
+    }
+
+private:
+    static constexpr int kNewBit = 4;
+    static constexpr int kIndexMask = 3;
+
+    T slots[3] {};
+    int backIndex = 0;              // writer-owned
+    int frontIndex = 1;             // reader-owned
+    std::atomic<int> state {2};     // middle slot index | kNewBit if unread
+};
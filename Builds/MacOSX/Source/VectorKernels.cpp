@@ -0,0 +1,592 @@
+// VectorKernels.cpp
+#include "VectorKernels.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+ #define MDP_KERNELS_X86 1
+ #include <immintrin.h>
+#else
+ #define MDP_KERNELS_X86 0
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+ #define MDP_KERNELS_NEON 1
+ #include <arm_neon.h>
+#else
+ #define MDP_KERNELS_NEON 0
+#endif
+
+//==============================================================================
+// Scalar reference. sumSquares accumulates in double like the original engine loops.
+namespace
+{
+    float sumSquaresScalar(const float* x, int n)
+    {
+        double acc = 0.0;
+        for (int i = 0; i < n; ++i)
+            acc += double(x[i]) * double(x[i]);
+        return static_cast<float>(acc);
+    }
+
+    void scaleInPlaceScalar(float* x, int n, float gain)
+    {
+        for (int i = 0; i < n; ++i)
+            x[i] *= gain;
+    }
+
+    void scaleAndAccumulateScalar(float* dst, const float* src, int n, float gain)
+    {
+        for (int i = 0; i < n; ++i)
+            dst[i] += src[i] * gain;
+    }
+
+    float peakScalar(const float* x, int n)
+    {
+        float p = 0.f;
+        for (int i = 0; i < n; ++i)
+            p = std::max(p, std::abs(x[i]));
+        return p;
+    }
+
+    // Gains are computed from the index rather than accumulated, so SIMD and
+    // scalar paths agree and long blocks don't drift off the end value.
+    void scaleInPlaceRampScalar(float* x, int n, float startGain, float endGain)
+    {
+        if (n <= 0)
+            return;
+        const float step = (endGain - startGain) / float(n);
+        for (int i = 0; i < n; ++i)
+            x[i] *= startGain + step * float(i + 1);
+    }
+
+    void scaleAndAccumulateRampScalar(float* dst, const float* src, int n, float startGain, float endGain)
+    {
+        if (n <= 0)
+            return;
+        const float step = (endGain - startGain) / float(n);
+        for (int i = 0; i < n; ++i)
+            dst[i] += src[i] * (startGain + step * float(i + 1));
+    }
+}
+
+//==============================================================================
+#if MDP_KERNELS_X86
+namespace
+{
+    __attribute__((target("avx2,fma")))
+    float hsum256(__m256 v)
+    {
+        __m128 lo = _mm256_castps256_ps128(v);
+        __m128 hi = _mm256_extractf128_ps(v, 1);
+        lo = _mm_add_ps(lo, hi);
+        lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+        lo = _mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 0x55));
+        return _mm_cvtss_f32(lo);
+    }
+
+    __attribute__((target("avx2,fma")))
+    float hmax256(__m256 v)
+    {
+        __m128 lo = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        lo = _mm_max_ps(lo, _mm_movehl_ps(lo, lo));
+        lo = _mm_max_ss(lo, _mm_shuffle_ps(lo, lo, 0x55));
+        return _mm_cvtss_f32(lo);
+    }
+
+    // Four independent accumulators hide the FMA latency; lanes are summed once at the end.
+    __attribute__((target("avx2,fma")))
+    float sumSquaresAvx2(const float* x, int n)
+    {
+        __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+        __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+        int i = 0;
+        for (; i + 32 <= n; i += 32)
+        {
+            __m256 v0 = _mm256_loadu_ps(x + i);
+            __m256 v1 = _mm256_loadu_ps(x + i + 8);
+            __m256 v2 = _mm256_loadu_ps(x + i + 16);
+            __m256 v3 = _mm256_loadu_ps(x + i + 24);
+            a0 = _mm256_fmadd_ps(v0, v0, a0);
+            a1 = _mm256_fmadd_ps(v1, v1, a1);
+            a2 = _mm256_fmadd_ps(v2, v2, a2);
+            a3 = _mm256_fmadd_ps(v3, v3, a3);
+        }
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256 v = _mm256_loadu_ps(x + i);
+            a0 = _mm256_fmadd_ps(v, v, a0);
+        }
+        float acc = hsum256(_mm256_add_ps(_mm256_add_ps(a0, a1), _mm256_add_ps(a2, a3)));
+        for (; i < n; ++i)
+            acc += x[i] * x[i];
+        return acc;
+    }
+
+    __attribute__((target("avx2,fma")))
+    void scaleInPlaceAvx2(float* x, int n, float gain)
+    {
+        const __m256 g = _mm256_set1_ps(gain);
+        int i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            _mm256_storeu_ps(x + i,     _mm256_mul_ps(_mm256_loadu_ps(x + i), g));
+            _mm256_storeu_ps(x + i + 8, _mm256_mul_ps(_mm256_loadu_ps(x + i + 8), g));
+        }
+        for (; i + 8 <= n; i += 8)
+            _mm256_storeu_ps(x + i, _mm256_mul_ps(_mm256_loadu_ps(x + i), g));
+        for (; i < n; ++i)
+            x[i] *= gain;
+    }
+
+    __attribute__((target("avx2,fma")))
+    void scaleAndAccumulateAvx2(float* dst, const float* src, int n, float gain)
+    {
+        const __m256 g = _mm256_set1_ps(gain);
+        int i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(_mm256_loadu_ps(src + i), g, _mm256_loadu_ps(dst + i)));
+            _mm256_storeu_ps(dst + i + 8, _mm256_fmadd_ps(_mm256_loadu_ps(src + i + 8), g, _mm256_loadu_ps(dst + i + 8)));
+        }
+        for (; i + 8 <= n; i += 8)
+            _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(_mm256_loadu_ps(src + i), g, _mm256_loadu_ps(dst + i)));
+        for (; i < n; ++i)
+            dst[i] += src[i] * gain;
+    }
+
+    __attribute__((target("avx2,fma")))
+    float peakAvx2(const float* x, int n)
+    {
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+        __m256 m0 = _mm256_setzero_ps(), m1 = _mm256_setzero_ps();
+        int i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            m0 = _mm256_max_ps(m0, _mm256_and_ps(_mm256_loadu_ps(x + i), absMask));
+            m1 = _mm256_max_ps(m1, _mm256_and_ps(_mm256_loadu_ps(x + i + 8), absMask));
+        }
+        for (; i + 8 <= n; i += 8)
+            m0 = _mm256_max_ps(m0, _mm256_and_ps(_mm256_loadu_ps(x + i), absMask));
+        float p = hmax256(_mm256_max_ps(m0, m1));
+        for (; i < n; ++i)
+            p = std::max(p, std::abs(x[i]));
+        return p;
+    }
+
+    __attribute__((target("avx2,fma")))
+    void scaleInPlaceRampAvx2(float* x, int n, float startGain, float endGain)
+    {
+        if (n <= 0)
+            return;
+        const float step = (endGain - startGain) / float(n);
+        const __m256 stepV  = _mm256_set1_ps(step);
+        const __m256 startV = _mm256_set1_ps(startGain);
+        const __m256 lanes  = _mm256_setr_ps(1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f);
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256 idx = _mm256_add_ps(_mm256_set1_ps(float(i)), lanes);
+            __m256 g = _mm256_fmadd_ps(idx, stepV, startV);
+            _mm256_storeu_ps(x + i, _mm256_mul_ps(_mm256_loadu_ps(x + i), g));
+        }
+        for (; i < n; ++i)
+            x[i] *= startGain + step * float(i + 1);
+    }
+
+    __attribute__((target("avx2,fma")))
+    void scaleAndAccumulateRampAvx2(float* dst, const float* src, int n, float startGain, float endGain)
+    {
+        if (n <= 0)
+            return;
+        const float step = (endGain - startGain) / float(n);
+        const __m256 stepV  = _mm256_set1_ps(step);
+        const __m256 startV = _mm256_set1_ps(startGain);
+        const __m256 lanes  = _mm256_setr_ps(1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f);
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256 idx = _mm256_add_ps(_mm256_set1_ps(float(i)), lanes);
+            __m256 g = _mm256_fmadd_ps(idx, stepV, startV);
+            _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(_mm256_loadu_ps(src + i), g, _mm256_loadu_ps(dst + i)));
+        }
+        for (; i < n; ++i)
+            dst[i] += src[i] * (startGain + step * float(i + 1));
+    }
+
+    //==========================================================================
+    // GCC 12's _mm512_max_ps / _mm512_reduce_* expand through _mm512_undefined_ps and
+    // trip -Wuninitialized, so max goes through the zero-masked form and horizontal
+    // reductions through a lane store (once per call, off the inner loop).
+    __attribute__((target("avx512f")))
+    __m512 max512(__m512 a, __m512 b)
+    {
+        return _mm512_maskz_max_ps(static_cast<__mmask16>(0xffff), a, b);
+    }
+
+    __attribute__((target("avx512f")))
+    __m512 abs512(__m512 v)
+    {
+        return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(v), _mm512_set1_epi32(0x7fffffff)));
+    }
+
+    __attribute__((target("avx512f")))
+    float hsum512(__m512 v)
+    {
+        alignas(64) float lanes[16];
+        _mm512_store_ps(lanes, v);
+        float acc = 0.f;
+        for (float f : lanes)
+            acc += f;
+        return acc;
+    }
+
+    __attribute__((target("avx512f")))
+    float hmax512(__m512 v)
+    {
+        alignas(64) float lanes[16];
+        _mm512_store_ps(lanes, v);
+        float m = 0.f;
+        for (float f : lanes)
+            m = std::max(m, f);
+        return m;
+    }
+
+    __attribute__((target("avx512f")))
+    float sumSquaresAvx512(const float* x, int n)
+    {
+        __m512 a0 = _mm512_setzero_ps(), a1 = _mm512_setzero_ps();
+        __m512 a2 = _mm512_setzero_ps(), a3 = _mm512_setzero_ps();
+        int i = 0;
+        for (; i + 64 <= n; i += 64)
+        {
+            __m512 v0 = _mm512_loadu_ps(x + i);
+            __m512 v1 = _mm512_loadu_ps(x + i + 16);
+            __m512 v2 = _mm512_loadu_ps(x + i + 32);
+            __m512 v3 = _mm512_loadu_ps(x + i + 48);
+            a0 = _mm512_fmadd_ps(v0, v0, a0);
+            a1 = _mm512_fmadd_ps(v1, v1, a1);
+            a2 = _mm512_fmadd_ps(v2, v2, a2);
+            a3 = _mm512_fmadd_ps(v3, v3, a3);
+        }
+        for (; i + 16 <= n; i += 16)
+        {
+            __m512 v = _mm512_loadu_ps(x + i);
+            a0 = _mm512_fmadd_ps(v, v, a0);
+        }
+        if (i < n)
+        {
+            const __mmask16 m = static_cast<__mmask16>((1u << (n - i)) - 1u);
+            __m512 v = _mm512_maskz_loadu_ps(m, x + i);
+            a1 = _mm512_fmadd_ps(v, v, a1);
+        }
+        return hsum512(_mm512_add_ps(_mm512_add_ps(a0, a1), _mm512_add_ps(a2, a3)));
+    }
+
+    __attribute__((target("avx512f")))
+    void scaleInPlaceAvx512(float* x, int n, float gain)
+    {
+        const __m512 g = _mm512_set1_ps(gain);
+        int i = 0;
+        for (; i + 32 <= n; i += 32)
+        {
+            _mm512_storeu_ps(x + i,      _mm512_mul_ps(_mm512_loadu_ps(x + i), g));
+            _mm512_storeu_ps(x + i + 16, _mm512_mul_ps(_mm512_loadu_ps(x + i + 16), g));
+        }
+        for (; i + 16 <= n; i += 16)
+            _mm512_storeu_ps(x + i, _mm512_mul_ps(_mm512_loadu_ps(x + i), g));
+        if (i < n)
+        {
+            const __mmask16 m = static_cast<__mmask16>((1u << (n - i)) - 1u);
+            _mm512_mask_storeu_ps(x + i, m, _mm512_mul_ps(_mm512_maskz_loadu_ps(m, x + i), g));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void scaleAndAccumulateAvx512(float* dst, const float* src, int n, float gain)
+    {
+        const __m512 g = _mm512_set1_ps(gain);
+        int i = 0;
+        for (; i + 32 <= n; i += 32)
+        {
+            _mm512_storeu_ps(dst + i, _mm512_fmadd_ps(_mm512_loadu_ps(src + i), g, _mm512_loadu_ps(dst + i)));
+            _mm512_storeu_ps(dst + i + 16, _mm512_fmadd_ps(_mm512_loadu_ps(src + i + 16), g, _mm512_loadu_ps(dst + i + 16)));
+        }
+        for (; i + 16 <= n; i += 16)
+            _mm512_storeu_ps(dst + i, _mm512_fmadd_ps(_mm512_loadu_ps(src + i), g, _mm512_loadu_ps(dst + i)));
+        if (i < n)
+        {
+            const __mmask16 m = static_cast<__mmask16>((1u << (n - i)) - 1u);
+            __m512 d = _mm512_maskz_loadu_ps(m, dst + i);
+            _mm512_mask_storeu_ps(dst + i, m, _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, src + i), g, d));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    float peakAvx512(const float* x, int n)
+    {
+        __m512 m0 = _mm512_setzero_ps(), m1 = _mm512_setzero_ps();
+        int i = 0;
+        for (; i + 32 <= n; i += 32)
+        {
+            m0 = max512(m0, abs512(_mm512_loadu_ps(x + i)));
+            m1 = max512(m1, abs512(_mm512_loadu_ps(x + i + 16)));
+        }
+        for (; i + 16 <= n; i += 16)
+            m0 = max512(m0, abs512(_mm512_loadu_ps(x + i)));
+        if (i < n)
+        {
+            const __mmask16 m = static_cast<__mmask16>((1u << (n - i)) - 1u);
+            m1 = max512(m1, abs512(_mm512_maskz_loadu_ps(m, x + i)));
+        }
+        return hmax512(max512(m0, m1));
+    }
+
+    __attribute__((target("avx512f")))
+    void scaleInPlaceRampAvx512(float* x, int n, float startGain, float endGain)
+    {
+        if (n <= 0)
+            return;
+        const float step = (endGain - startGain) / float(n);
+        const __m512 stepV  = _mm512_set1_ps(step);
+        const __m512 startV = _mm512_set1_ps(startGain);
+        const __m512 lanes  = _mm512_setr_ps(1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f,
+                                             9.f, 10.f, 11.f, 12.f, 13.f, 14.f, 15.f, 16.f);
+        int i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            __m512 idx = _mm512_add_ps(_mm512_set1_ps(float(i)), lanes);
+            __m512 g = _mm512_fmadd_ps(idx, stepV, startV);
+            _mm512_storeu_ps(x + i, _mm512_mul_ps(_mm512_loadu_ps(x + i), g));
+        }
+        if (i < n)
+        {
+            const __mmask16 m = static_cast<__mmask16>((1u << (n - i)) - 1u);
+            __m512 idx = _mm512_add_ps(_mm512_set1_ps(float(i)), lanes);
+            __m512 g = _mm512_fmadd_ps(idx, stepV, startV);
+            _mm512_mask_storeu_ps(x + i, m, _mm512_mul_ps(_mm512_maskz_loadu_ps(m, x + i), g));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void scaleAndAccumulateRampAvx512(float* dst, const float* src, int n, float startGain, float endGain)
+    {
+        if (n <= 0)
+            return;
+        const float step = (endGain - startGain) / float(n);
+        const __m512 stepV  = _mm512_set1_ps(step);
+        const __m512 startV = _mm512_set1_ps(startGain);
+        const __m512 lanes  = _mm512_setr_ps(1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f,
+                                             9.f, 10.f, 11.f, 12.f, 13.f, 14.f, 15.f, 16.f);
+        int i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            __m512 idx = _mm512_add_ps(_mm512_set1_ps(float(i)), lanes);
+            __m512 g = _mm512_fmadd_ps(idx, stepV, startV);
+            _mm512_storeu_ps(dst + i, _mm512_fmadd_ps(_mm512_loadu_ps(src + i), g, _mm512_loadu_ps(dst + i)));
+        }
+        if (i < n)
+        {
+            const __mmask16 m = static_cast<__mmask16>((1u << (n - i)) - 1u);
+            __m512 idx = _mm512_add_ps(_mm512_set1_ps(float(i)), lanes);
+            __m512 g = _mm512_fmadd_ps(idx, stepV, startV);
+            __m512 d = _mm512_maskz_loadu_ps(m, dst + i);
+            _mm512_mask_storeu_ps(dst + i, m, _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, src + i), g, d));
+        }
+    }
+
+    bool cpuHasAvx2()
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+
+    bool cpuHasAvx512()
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx512f");
+    }
+}
+#endif
+
+//==============================================================================
+#if MDP_KERNELS_NEON
+namespace
+{
+    float sumSquaresNeon(const float* x, int n)
+    {
+        float32x4_t a0 = vdupq_n_f32(0.f), a1 = vdupq_n_f32(0.f);
+        float32x4_t a2 = vdupq_n_f32(0.f), a3 = vdupq_n_f32(0.f);
+        int i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            float32x4_t v0 = vld1q_f32(x + i),     v1 = vld1q_f32(x + i + 4);
+            float32x4_t v2 = vld1q_f32(x + i + 8), v3 = vld1q_f32(x + i + 12);
+            a0 = vfmaq_f32(a0, v0, v0);
+            a1 = vfmaq_f32(a1, v1, v1);
+            a2 = vfmaq_f32(a2, v2, v2);
+            a3 = vfmaq_f32(a3, v3, v3);
+        }
+        for (; i + 4 <= n; i += 4)
+        {
+            float32x4_t v = vld1q_f32(x + i);
+            a0 = vfmaq_f32(a0, v, v);
+        }
+        float acc = vaddvq_f32(vaddq_f32(vaddq_f32(a0, a1), vaddq_f32(a2, a3)));
+        for (; i < n; ++i)
+            acc += x[i] * x[i];
+        return acc;
+    }
+
+    void scaleInPlaceNeon(float* x, int n, float gain)
+    {
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            vst1q_f32(x + i,     vmulq_n_f32(vld1q_f32(x + i), gain));
+            vst1q_f32(x + i + 4, vmulq_n_f32(vld1q_f32(x + i + 4), gain));
+        }
+        for (; i < n; ++i)
+            x[i] *= gain;
+    }
+
+    void scaleAndAccumulateNeon(float* dst, const float* src, int n, float gain)
+    {
+        const float32x4_t g = vdupq_n_f32(gain);
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            vst1q_f32(dst + i,     vfmaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), g));
+            vst1q_f32(dst + i + 4, vfmaq_f32(vld1q_f32(dst + i + 4), vld1q_f32(src + i + 4), g));
+        }
+        for (; i < n; ++i)
+            dst[i] += src[i] * gain;
+    }
+
+    float peakNeon(const float* x, int n)
+    {
+        float32x4_t m0 = vdupq_n_f32(0.f), m1 = vdupq_n_f32(0.f);
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            m0 = vmaxq_f32(m0, vabsq_f32(vld1q_f32(x + i)));
+            m1 = vmaxq_f32(m1, vabsq_f32(vld1q_f32(x + i + 4)));
+        }
+        float p = vmaxvq_f32(vmaxq_f32(m0, m1));
+        for (; i < n; ++i)
+            p = std::max(p, std::abs(x[i]));
+        return p;
+    }
+
+    void scaleInPlaceRampNeon(float* x, int n, float startGain, float endGain)
+    {
+        if (n <= 0)
+            return;
+        const float step = (endGain - startGain) / float(n);
+        const float32x4_t stepV  = vdupq_n_f32(step);
+        const float32x4_t startV = vdupq_n_f32(startGain);
+        const float lanesInit[4] = { 1.f, 2.f, 3.f, 4.f };
+        const float32x4_t lanes = vld1q_f32(lanesInit);
+        int i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            float32x4_t idx = vaddq_f32(vdupq_n_f32(float(i)), lanes);
+            float32x4_t g = vfmaq_f32(startV, idx, stepV);
+            vst1q_f32(x + i, vmulq_f32(vld1q_f32(x + i), g));
+        }
+        for (; i < n; ++i)
+            x[i] *= startGain + step * float(i + 1);
+    }
+
+    void scaleAndAccumulateRampNeon(float* dst, const float* src, int n, float startGain, float endGain)
+    {
+        if (n <= 0)
+            return;
+        const float step = (endGain - startGain) / float(n);
+        const float32x4_t stepV  = vdupq_n_f32(step);
+        const float32x4_t startV = vdupq_n_f32(startGain);
+        const float lanesInit[4] = { 1.f, 2.f, 3.f, 4.f };
+        const float32x4_t lanes = vld1q_f32(lanesInit);
+        int i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            float32x4_t idx = vaddq_f32(vdupq_n_f32(float(i)), lanes);
+            float32x4_t g = vfmaq_f32(startV, idx, stepV);
+            vst1q_f32(dst + i, vfmaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), g));
+        }
+        for (; i < n; ++i)
+            dst[i] += src[i] * (startGain + step * float(i + 1));
+    }
+}
+#endif
+
+//==============================================================================
+const VectorKernels& VectorKernels::scalarKernels()
+{
+    static const VectorKernels k { Level::scalar, "scalar",
+                                   sumSquaresScalar, scaleInPlaceScalar,
+                                   scaleAndAccumulateScalar, peakScalar,
+                                   scaleInPlaceRampScalar, scaleAndAccumulateRampScalar };
+    return k;
+}
+
+const VectorKernels* VectorKernels::forLevel(Level l)
+{
+    switch (l)
+    {
+        case Level::scalar:
+            return &scalarKernels();
+
+        case Level::neon:
+           #if MDP_KERNELS_NEON
+            {
+                static const VectorKernels k { Level::neon, "neon",
+                                               sumSquaresNeon, scaleInPlaceNeon,
+                                               scaleAndAccumulateNeon, peakNeon,
+                                               scaleInPlaceRampNeon, scaleAndAccumulateRampNeon };
+                return &k;
+            }
+           #else
+            return nullptr;
+           #endif
+
+        case Level::avx2:
+           #if MDP_KERNELS_X86
+            if (cpuHasAvx2())
+            {
+                static const VectorKernels k { Level::avx2, "avx2",
+                                               sumSquaresAvx2, scaleInPlaceAvx2,
+                                               scaleAndAccumulateAvx2, peakAvx2,
+                                               scaleInPlaceRampAvx2, scaleAndAccumulateRampAvx2 };
+                return &k;
+            }
+           #endif
+            return nullptr;
+
+        case Level::avx512:
+           #if MDP_KERNELS_X86
+            if (cpuHasAvx512())
+            {
+                static const VectorKernels k { Level::avx512, "avx512",
+                                               sumSquaresAvx512, scaleInPlaceAvx512,
+                                               scaleAndAccumulateAvx512, peakAvx512,
+                                               scaleInPlaceRampAvx512, scaleAndAccumulateRampAvx512 };
+                return &k;
+            }
+           #endif
+            return nullptr;
+    }
+    return nullptr;
+}
+
+const VectorKernels& VectorKernels::select()
+{
+    static const VectorKernels* best = []
+    {
+        for (auto l : { Level::avx512, Level::avx2, Level::neon })
+            if (auto* k = forLevel(l))
+                return k;
+        return &scalarKernels();
+    }();
+    return *best;
+}
@@ -0,0 +1,55 @@
+// VectorKernels.h
+#pragma once
+
+/**
+    VectorKernels:
+    - Small table of hot-loop kernels shared by both automix engines and the processor.
+    - select() inspects the CPU once and returns the widest implementation available
+      (AVX-512 or AVX2 on x86-64, NEON on arm64, scalar otherwise). Engines grab the
+      table in prepare() and call through it on the audio thread, so there is no
+      feature test per block.
+    - All kernels accept unaligned pointers and any n >= 0.
+*/
+struct VectorKernels
+{
+    enum class Level
+    {
+        scalar,
+        neon,
+        avx2,
+        avx512
+    };
+
+    // Sum of x[i]^2.
+    using SumSquaresFn         = float (*)(const float* x, int n);
+    // x[i] *= gain.
+    using ScaleInPlaceFn       = void  (*)(float* x, int n, float gain);
+    // dst[i] += src[i] * gain. dst and src must not overlap.
+    using ScaleAndAccumulateFn = void  (*)(float* dst, const float* src, int n, float gain);
+    // max |x[i]|, 0 for n == 0.
+    using PeakFn               = float (*)(const float* x, int n);
+    // x[i] *= startGain + (endGain - startGain) * (i + 1) / n, so the last sample
+    // lands exactly on endGain and the next block can start from there.
+    using ScaleInPlaceRampFn   = void  (*)(float* x, int n, float startGain, float endGain);
+    // dst[i] += src[i] * (the same ramp). dst and src must not overlap.
+    using ScaleAndAccumulateRampFn = void (*)(float* dst, const float* src, int n, float startGain, float endGain);
+
+    Level level;
+    const char* name;
+
+    SumSquaresFn         sumSquares;
+    ScaleInPlaceFn       scaleInPlace;
+    ScaleAndAccumulateFn scaleAndAccumulate;
+    PeakFn               peak;
+    ScaleInPlaceRampFn   scaleInPlaceRamp;
+    ScaleAndAccumulateRampFn scaleAndAccumulateRamp;
+
+    // Best implementation for the running CPU. Detection runs once per process.
+    static const VectorKernels& select();
+
+    // A specific implementation, or nullptr if this build/CPU can't run it.
+    // Used by the benchmarks to compare levels side by side.
+    static const VectorKernels* forLevel(Level l);
+
+    static const VectorKernels& scalarKernels();
+};
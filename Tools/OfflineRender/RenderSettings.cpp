@@ -0,0 +1,197 @@
+// RenderSettings.cpp
+#include "RenderSettings.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    enum class Kind { Number, Switch, Renderer };
+
+    using Setter = void (*)(EnhancedDuganAGC&, int channel, float value);
+
+    struct Key
+    {
+        const char* name;
+        Kind kind;
+        bool perChannel;
+        Setter apply;
+    };
+
+    // Index 0 and 1 are the renderer's own keys; the rest map onto engine setters.
+    const Key keys[] =
+    {
+        { "blockSize",          Kind::Renderer, false, nullptr },
+        { "sidechainChannels",  Kind::Renderer, false, nullptr },
+
+        { "masterGain",         Kind::Number, false, [](EnhancedDuganAGC& e, int, float v) { e.setMasterGain(v); } },
+        { "gateThreshold",      Kind::Number, false, [](EnhancedDuganAGC& e, int, float v) { e.setGateThreshold(v); } },
+        { "gateHysteresis",     Kind::Number, false, [](EnhancedDuganAGC& e, int, float v) { e.setGateHysteresis(v); } },
+        { "gateCloseDb",        Kind::Number, false, [](EnhancedDuganAGC& e, int, float v) { e.setGateCloseDb(v); } },
+        { "gateAttackMs",       Kind::Number, false, [](EnhancedDuganAGC& e, int, float v) { e.setGateAttackMs(v); } },
+        { "gateReleaseMs",      Kind::Number, false, [](EnhancedDuganAGC& e, int, float v) { e.setGateReleaseMs(v); } },
+        { "lastMicOn",          Kind::Switch, false, [](EnhancedDuganAGC& e, int, float v) { e.setLastMicOn(v != 0.f); } },
+        { "shortTermMs",        Kind::Number, false, [](EnhancedDuganAGC& e, int, float v) { e.setShortTermMs(v); } },
+        { "longTermMs",         Kind::Number, false, [](EnhancedDuganAGC& e, int, float v) { e.setLongTermMs(v); } },
+        { "lookaheadMs",        Kind::Number, false, [](EnhancedDuganAGC& e, int, float v) { e.setLookaheadMs(v); } },
+        { "zeroLatency",        Kind::Switch, false, [](EnhancedDuganAGC& e, int, float v) { e.setZeroLatency(v != 0.f); } },
+        { "controlBlockSize",   Kind::Number, false, [](EnhancedDuganAGC& e, int, float v) { e.setControlBlockSize(static_cast<int>(v)); } },
+        { "linkLeveler",        Kind::Switch, false, [](EnhancedDuganAGC& e, int, float v) { e.setLinkLeveler(v != 0.f); } },
+        { "levelerRangeDb",     Kind::Number, false, [](EnhancedDuganAGC& e, int, float v) { e.setLevelerRangeDb(v); } },
+        { "adaptiveThreshold",  Kind::Switch, false, [](EnhancedDuganAGC& e, int, float v) { e.setUseAdaptiveThreshold(v != 0.f); } },
+        { "sidechainInfluence", Kind::Number, false, [](EnhancedDuganAGC& e, int, float v) { e.setSidechainInfluence(v); } },
+        { "ducking",            Kind::Switch, false, [](EnhancedDuganAGC& e, int, float v) { e.setDuckingEnabled(v != 0.f); } },
+        { "duckThresholdDb",    Kind::Number, false, [](EnhancedDuganAGC& e, int, float v) { e.setDuckThresholdDb(v); } },
+        { "duckDepthDb",        Kind::Number, false, [](EnhancedDuganAGC& e, int, float v) { e.setDuckDepthDb(v); } },
+        { "duckAttackMs",       Kind::Number, false, [](EnhancedDuganAGC& e, int, float v) { e.setDuckAttackMs(v); } },
+        { "duckReleaseMs",      Kind::Number, false, [](EnhancedDuganAGC& e, int, float v) { e.setDuckReleaseMs(v); } },
+        { "crossTalk",          Kind::Switch, false, [](EnhancedDuganAGC& e, int, float v) { e.setCrossTalkSuppression(v != 0.f); } },
+
+        { "mute",               Kind::Switch, true,  [](EnhancedDuganAGC& e, int ch, float v) { e.setChannelMute(ch, v != 0.f); } },
+        { "bypass",             Kind::Switch, true,  [](EnhancedDuganAGC& e, int ch, float v) { e.setChannelBypass(ch, v != 0.f); } },
+        { "automix",            Kind::Switch, true,  [](EnhancedDuganAGC& e, int ch, float v) { e.setChannelAutomixOn(ch, v != 0.f); } },
+        { "sensDb",             Kind::Number, true,  [](EnhancedDuganAGC& e, int ch, float v) { e.setChannelSensDb(ch, v); } },
+        { "faderDb",            Kind::Number, true,  [](EnhancedDuganAGC& e, int ch, float v) { e.setChannelFaderDb(ch, v); } },
+    };
+
+    const int numKeys = static_cast<int>(sizeof(keys) / sizeof(keys[0]));
+
+    std::string trim(const std::string& s)
+    {
+        const auto begin = s.find_first_not_of(" \t\r");
+        if (begin == std::string::npos)
+            return {};
+        return s.substr(begin, s.find_last_not_of(" \t\r") - begin + 1);
+    }
+
+    bool parseNumber(const std::string& text, float& value)
+    {
+        char* end = nullptr;
+        errno = 0;
+        value = std::strtof(text.c_str(), &end);
+        return errno == 0 && end != text.c_str() && *end == '\0';
+    }
+
+    bool parseSwitch(const std::string& text, float& value)
+    {
+        if (text == "on" || text == "true" || text == "1")       { value = 1.f; return true; }
+        if (text == "off" || text == "false" || text == "0")     { value = 0.f; return true; }
+        return false;
+    }
+}
+
+bool RenderSettings::load(const std::string& path, std::string& error)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    entries.clear();
+    std::string line;
+    for (int lineNumber = 1; std::getline(in, line); ++lineNumber)
+    {
+        const std::string where = path + ":" + std::to_string(lineNumber) + ": ";
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty())
+            continue;
+
+        const auto equals = line.find('=');
+        if (equals == std::string::npos)
+        {
+            error = where + "expected key = value";
+            return false;
+        }
+
+        std::string name = trim(line.substr(0, equals));
+        const std::string valueText = trim(line.substr(equals + 1));
+
+        Entry entry;
+        const auto dot = name.find('.');
+        if (dot != std::string::npos)
+        {
+            float channel = 0.f;
+            if (!parseNumber(name.substr(dot + 1), channel) || channel < 0.f || channel != static_cast<int>(channel))
+            {
+                error = where + "bad channel in '" + name + "'";
+                return false;
+            }
+            entry.channel = static_cast<int>(channel);
+            name.resize(dot);
+        }
+
+        if (name == "speechGating")
+        {
+            error = where + "speechGating is not supported offline: its analysis is asynchronous, so renders would not be repeatable";
+            return false;
+        }
+
+        entry.key = -1;
+        for (int k = 0; k < numKeys; ++k)
+            if (name == keys[k].name)
+                entry.key = k;
+
+        if (entry.key < 0)
+        {
+            error = where + "unknown key '" + name + "'";
+            return false;
+        }
+
+        const Key& key = keys[entry.key];
+        if (key.perChannel != (entry.channel >= 0))
+        {
+            error = where + "'" + name + (key.perChannel ? "' needs a channel, e.g. " + name + ".0" : "' takes no channel");
+            return false;
+        }
+
+        const bool parsed = key.kind == Kind::Switch ? parseSwitch(valueText, entry.value)
+                                                     : parseNumber(valueText, entry.value);
+        if (!parsed)
+        {
+            error = where + "bad value '" + valueText + "' for " + name;
+            return false;
+        }
+
+        if (key.kind == Kind::Renderer)
+        {
+            const int v = static_cast<int>(entry.value);
+            if (entry.key == 0)
+            {
+                if (v < 1)
+                {
+                    error = where + "blockSize must be at least 1";
+                    return false;
+                }
+                blockSize = v;
+            }
+            else
+            {
+                sidechainChannels = std::max(0, v);
+            }
+            continue;
+        }
+
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+void RenderSettings::applyGlobal(EnhancedDuganAGC& engine) const
+{
+    for (const auto& entry : entries)
+        if (!keys[entry.key].perChannel)
+            keys[entry.key].apply(engine, -1, entry.value);
+}
+
+void RenderSettings::applyChannels(EnhancedDuganAGC& engine, int numChannels) const
+{
+    for (const auto& entry : entries)
+        if (keys[entry.key].perChannel && entry.channel < numChannels)
+            keys[entry.key].apply(engine, entry.channel, entry.value);
+}
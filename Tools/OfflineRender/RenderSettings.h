@@ -0,0 +1,45 @@
+// RenderSettings.h
+#pragma once
+
+#include "EnhancedDuganAGC.h"
+
+#include <string>
+#include <vector>
+
+/**
+    RenderSettings:
+    - The parameter file of the offline renderer: one "key = value" per line,
+      '#' starts a comment. Engine keys are named after the engine setters
+      (gateThreshold, lookaheadMs, crossTalk, duckDepthDb, ...); per-channel
+      keys take the channel after a dot, e.g. "faderDb.3 = -6" or "mute.0 = on".
+    - blockSize and sidechainChannels belong to the renderer itself: the block
+      size fed to processBlock() (also the resolution of the gain tracks) and how
+      many of the file's last channels make up the sidechain bus.
+    - Speech gating is rejected. Its analysis runs asynchronously on a background
+      thread, so an offline render would not be repeatable.
+    - load() reports the first bad line through error and returns false.
+*/
+struct RenderSettings
+{
+    int blockSize = 512;
+    int sidechainChannels = 0;
+
+    bool load(const std::string& path, std::string& error);
+
+    // Global engine settings; call before prepare().
+    void applyGlobal(EnhancedDuganAGC& engine) const;
+
+    // Per-channel engine settings; call after prepare(). Entries beyond
+    // numChannels are ignored.
+    void applyChannels(EnhancedDuganAGC& engine, int numChannels) const;
+
+private:
+    struct Entry
+    {
+        int key = 0;
+        int channel = -1;
+        float value = 0.f;
+    };
+
+    std::vector<Entry> entries;
+};
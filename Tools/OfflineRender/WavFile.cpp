@@ -0,0 +1,314 @@
+// WavFile.cpp
+#include "WavFile.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // Header layout of the files WavWriter produces: RIFF header, a JUNK chunk that
+    // becomes ds64 for RF64, fmt, then data.
+    constexpr long kJunkOffset = 12;
+    constexpr std::uint32_t kDs64BodySize = 28;
+    constexpr long kDataSizeOffset = 76;
+    constexpr long kHeaderSize = 80;
+
+    constexpr std::uint16_t kFormatPcm = 1;
+    constexpr std::uint16_t kFormatFloat = 3;
+    constexpr std::uint16_t kFormatExtensible = 0xFFFE;
+
+    bool seekTo(std::FILE* f, std::int64_t position)
+    {
+       #if defined(_WIN32)
+        return _fseeki64(f, position, SEEK_SET) == 0;
+       #else
+        return fseeko(f, static_cast<off_t>(position), SEEK_SET) == 0;
+       #endif
+    }
+
+    bool skip(std::FILE* f, std::int64_t bytes)
+    {
+       #if defined(_WIN32)
+        return _fseeki64(f, bytes, SEEK_CUR) == 0;
+       #else
+        return fseeko(f, static_cast<off_t>(bytes), SEEK_CUR) == 0;
+       #endif
+    }
+
+    // Little-endian fields, whatever the host's byte order:
+    std::uint16_t get16(const unsigned char* p) { return static_cast<std::uint16_t>(p[0] | (p[1] << 8)); }
+    std::uint32_t get32(const unsigned char* p) { return get16(p) | (static_cast<std::uint32_t>(get16(p + 2)) << 16); }
+    std::uint64_t get64(const unsigned char* p) { return get32(p) | (static_cast<std::uint64_t>(get32(p + 4)) << 32); }
+
+    void put32(unsigned char* p, std::uint32_t v)
+    {
+        for (int i = 0; i < 4; ++i)
+            p[i] = static_cast<unsigned char>(v >> (8 * i));
+    }
+
+    void put64(unsigned char* p, std::uint64_t v)
+    {
+        put32(p, static_cast<std::uint32_t>(v));
+        put32(p + 4, static_cast<std::uint32_t>(v >> 32));
+    }
+
+    bool readExact(std::FILE* f, void* dst, size_t n) { return std::fread(dst, 1, n, f) == n; }
+}
+
+//==============================================================================
+WavReader::~WavReader()
+{
+    close();
+}
+
+void WavReader::close()
+{
+    if (file != nullptr)
+        std::fclose(file);
+    file = nullptr;
+}
+
+bool WavReader::fail(const std::string& message)
+{
+    error = message;
+    close();
+    return false;
+}
+
+bool WavReader::open(const std::string& path)
+{
+    close();
+    error.clear();
+    file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return fail("cannot open " + path);
+
+    unsigned char header[12];
+    if (!readExact(file, header, sizeof(header)) || std::memcmp(header + 8, "WAVE", 4) != 0)
+        return fail(path + " is not a WAV file");
+    const bool rf64 = std::memcmp(header, "RF64", 4) == 0 || std::memcmp(header, "BW64", 4) == 0;
+    if (!rf64 && std::memcmp(header, "RIFF", 4) != 0)
+        return fail(path + " is not a WAV file");
+
+    std::uint64_t ds64DataSize = 0;
+    bool haveFormat = false;
+    int blockAlign = 0;
+    for (;;)
+    {
+        unsigned char chunk[8];
+        if (!readExact(file, chunk, sizeof(chunk)))
+            return fail(path + ": no data chunk");
+        const std::uint32_t size = get32(chunk + 4);
+
+        if (std::memcmp(chunk, "ds64", 4) == 0)
+        {
+            unsigned char body[24];
+            if (size < sizeof(body) || !readExact(file, body, sizeof(body)))
+                return fail(path + ": bad ds64 chunk");
+            ds64DataSize = get64(body + 8);
+            skip(file, static_cast<std::int64_t>(size - sizeof(body)) + (size & 1));
+        }
+        else if (std::memcmp(chunk, "fmt ", 4) == 0)
+        {
+            unsigned char fmt[40] = {};
+            if (size < 16 || !readExact(file, fmt, std::min<size_t>(size, sizeof(fmt))))
+                return fail(path + ": bad fmt chunk");
+            if (size > sizeof(fmt))
+                skip(file, size - sizeof(fmt));
+            if (size & 1)
+                skip(file, 1);
+
+            std::uint16_t tag = get16(fmt);
+            if (tag == kFormatExtensible && size >= 40)
+                tag = get16(fmt + 24); // first two bytes of the sub-format GUID
+            numChannels = get16(fmt + 2);
+            sampleRate = get32(fmt + 4);
+            blockAlign = get16(fmt + 12);
+            const int bits = get16(fmt + 14);
+            bytesPerSample = bits / 8;
+            isFloat = tag == kFormatFloat;
+
+            const bool supported = (tag == kFormatPcm && (bits == 16 || bits == 24 || bits == 32))
+                                || (tag == kFormatFloat && (bits == 32 || bits == 64));
+            if (!supported || numChannels <= 0 || blockAlign != numChannels * bytesPerSample)
+                return fail(path + ": unsupported sample format");
+            haveFormat = true;
+        }
+        else if (std::memcmp(chunk, "data", 4) == 0)
+        {
+            if (!haveFormat)
+                return fail(path + ": data before fmt");
+            const std::uint64_t bytes = rf64 && size == 0xFFFFFFFFu ? ds64DataSize : size;
+            numFrames = static_cast<std::int64_t>(bytes / static_cast<std::uint64_t>(blockAlign));
+            framesLeft = numFrames;
+            return true;
+        }
+        else if (!skip(file, static_cast<std::int64_t>(size) + (size & 1)))
+        {
+            return fail(path + ": truncated");
+        }
+    }
+}
+
+int WavReader::read(float* const* channels, int maxFrames)
+{
+    if (file == nullptr || framesLeft <= 0)
+        return 0;
+
+    const int frames = static_cast<int>(std::min<std::int64_t>(maxFrames, framesLeft));
+    const size_t frameBytes = static_cast<size_t>(numChannels * bytesPerSample);
+    raw.resize(static_cast<size_t>(frames) * frameBytes);
+    const size_t got = std::fread(raw.data(), frameBytes, static_cast<size_t>(frames), file);
+    if (got == 0)
+    {
+        fail("unexpected end of file");
+        return 0;
+    }
+    const int n = static_cast<int>(got);
+    framesLeft -= n;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const unsigned char* p = raw.data() + static_cast<size_t>(ch * bytesPerSample);
+        float* out = channels[ch];
+        for (int i = 0; i < n; ++i, p += frameBytes)
+        {
+            switch (bytesPerSample)
+            {
+                case 2:
+                    out[i] = static_cast<float>(static_cast<std::int16_t>(get16(p))) * (1.f / 32768.f);
+                    break;
+                case 3:
+                {
+                    const std::int32_t v = static_cast<std::int32_t>((static_cast<std::uint32_t>(p[0]) << 8)
+                                         | (static_cast<std::uint32_t>(p[1]) << 16) | (static_cast<std::uint32_t>(p[2]) << 24)) >> 8;
+                    out[i] = static_cast<float>(v) * (1.f / 8388608.f);
+                    break;
+                }
+                case 4:
+                {
+                    const std::uint32_t bits = get32(p);
+                    if (isFloat)
+                        std::memcpy(&out[i], &bits, sizeof(float));
+                    else
+                        out[i] = static_cast<float>(static_cast<std::int32_t>(bits)) * (1.f / 2147483648.f);
+                    break;
+                }
+                default:
+                {
+                    const std::uint64_t bits = get64(p);
+                    double d;
+                    std::memcpy(&d, &bits, sizeof(double));
+                    out[i] = static_cast<float>(d);
+                    break;
+                }
+            }
+        }
+    }
+    return n;
+}
+
+//==============================================================================
+WavWriter::~WavWriter()
+{
+    close();
+}
+
+bool WavWriter::fail(const std::string& message)
+{
+    error = message;
+    if (file != nullptr)
+        std::fclose(file);
+    file = nullptr;
+    return false;
+}
+
+bool WavWriter::open(const std::string& path, int channels, double sampleRate)
+{
+    close();
+    error.clear();
+    numChannels = channels;
+    dataBytes = 0;
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        return fail("cannot create " + path);
+
+    unsigned char header[kHeaderSize] = {};
+    std::memcpy(header, "RIFF", 4);
+    std::memcpy(header + 8, "WAVE", 4);
+    std::memcpy(header + kJunkOffset, "JUNK", 4);
+    put32(header + kJunkOffset + 4, kDs64BodySize);
+
+    unsigned char* fmt = header + kJunkOffset + 8 + kDs64BodySize;
+    std::memcpy(fmt, "fmt ", 4);
+    put32(fmt + 4, 16);
+    const std::uint32_t rate = static_cast<std::uint32_t>(sampleRate + 0.5);
+    const std::uint32_t blockAlign = static_cast<std::uint32_t>(channels) * sizeof(float);
+    fmt[8] = kFormatFloat;
+    fmt[10] = static_cast<unsigned char>(channels);
+    fmt[11] = static_cast<unsigned char>(channels >> 8);
+    put32(fmt + 12, rate);
+    put32(fmt + 16, rate * blockAlign);
+    fmt[20] = static_cast<unsigned char>(blockAlign);
+    fmt[21] = static_cast<unsigned char>(blockAlign >> 8);
+    fmt[22] = 32;
+
+    std::memcpy(header + kDataSizeOffset - 4, "data", 4);
+    if (std::fwrite(header, 1, sizeof(header), file) != sizeof(header))
+        return fail("cannot write " + path);
+    return true;
+}
+
+bool WavWriter::write(const float* const* channels, int numFrames)
+{
+    if (file == nullptr)
+        return false;
+
+    interleaved.resize(static_cast<size_t>(numFrames) * static_cast<size_t>(numChannels));
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < numFrames; ++i)
+            interleaved[static_cast<size_t>(i * numChannels + ch)] = channels[ch][i];
+
+    // Float samples are written in host order; every supported host is little-endian.
+    const size_t n = interleaved.size();
+    if (std::fwrite(interleaved.data(), sizeof(float), n, file) != n)
+        return fail("write failed (disk full?)");
+    dataBytes += static_cast<std::int64_t>(n * sizeof(float));
+    return true;
+}
+
+bool WavWriter::close()
+{
+    if (file == nullptr)
+        return error.empty();
+
+    const std::uint64_t riffSize = static_cast<std::uint64_t>(kHeaderSize - 8 + dataBytes);
+    unsigned char field[8];
+    bool ok = true;
+    if (riffSize <= 0xFFFFFFFFu)
+    {
+        put32(field, static_cast<std::uint32_t>(riffSize));
+        ok &= seekTo(file, 4) && std::fwrite(field, 1, 4, file) == 4;
+        put32(field, static_cast<std::uint32_t>(dataBytes));
+        ok &= seekTo(file, kDataSizeOffset) && std::fwrite(field, 1, 4, file) == 4;
+    }
+    else
+    {
+        // RF64: the 32-bit sizes become 0xFFFFFFFF and the JUNK chunk becomes ds64.
+        unsigned char ds64[8 + kDs64BodySize] = {};
+        std::memcpy(ds64, "ds64", 4);
+        put32(ds64 + 4, kDs64BodySize);
+        put64(ds64 + 8, riffSize);
+        put64(ds64 + 16, static_cast<std::uint64_t>(dataBytes));
+        put64(ds64 + 24, static_cast<std::uint64_t>(dataBytes) / (static_cast<std::uint64_t>(numChannels) * sizeof(float)));
+        put32(field, 0xFFFFFFFFu);
+        ok &= seekTo(file, 0) && std::fwrite("RF64", 1, 4, file) == 4 && std::fwrite(field, 1, 4, file) == 4;
+        ok &= seekTo(file, kJunkOffset) && std::fwrite(ds64, 1, sizeof(ds64), file) == sizeof(ds64);
+        ok &= seekTo(file, kDataSizeOffset) && std::fwrite(field, 1, 4, file) == 4;
+    }
+
+    ok &= std::fclose(file) == 0;
+    file = nullptr;
+    if (!ok)
+        error = "cannot finish the file header";
+    return ok;
+}
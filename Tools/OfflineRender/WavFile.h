@@ -0,0 +1,72 @@
+// WavFile.h
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+    WavReader / WavWriter:
+    - Streaming WAV and RF64/BW64 I/O for the offline renderer. Only one chunk
+      of frames is ever held in memory; nothing reads a whole file.
+    - The reader takes PCM 16/24/32-bit and float 32/64-bit, plain or
+      WAVE_FORMAT_EXTENSIBLE, and hands out planar float frames.
+    - The writer writes 32-bit float. It reserves a JUNK chunk the size of a
+      ds64 chunk, so a file that grows past 4 GB is turned into RF64 in place
+      when it is closed.
+    - Errors come back as false plus getError(); there are no exceptions.
+*/
+class WavReader
+{
+public:
+    ~WavReader();
+
+    bool open(const std::string& path);
+    void close();
+
+    int getNumChannels() const { return numChannels; }
+    double getSampleRate() const { return sampleRate; }
+    std::int64_t getNumFrames() const { return numFrames; }
+    const std::string& getError() const { return error; }
+
+    // Reads up to maxFrames frames into channels[ch][0 .. n); returns n, 0 at the end
+    // of the data or on error (then getError() is set).
+    int read(float* const* channels, int maxFrames);
+
+private:
+    bool fail(const std::string& message);
+
+    std::FILE* file = nullptr;
+    int numChannels = 0;
+    double sampleRate = 0.0;
+    int bytesPerSample = 0;
+    bool isFloat = false;
+    std::int64_t numFrames = 0;
+    std::int64_t framesLeft = 0;
+    std::vector<unsigned char> raw;
+    std::string error;
+};
+
+class WavWriter
+{
+public:
+    ~WavWriter();
+
+    bool open(const std::string& path, int numChannels, double sampleRate);
+
+    // Patches the sizes (switching to RF64 past 4 GB) and closes the file.
+    bool close();
+
+    bool write(const float* const* channels, int numFrames);
+    const std::string& getError() const { return error; }
+
+private:
+    bool fail(const std::string& message);
+
+    std::FILE* file = nullptr;
+    int numChannels = 0;
+    std::int64_t dataBytes = 0;
+    std::vector<float> interleaved;
+    std::string error;
+};
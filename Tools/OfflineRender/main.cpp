@@ -0,0 +1,271 @@
+// main.cpp
+// mdp_render: renders multichannel WAV/RF64 recordings through EnhancedDuganAGC
+// offline, faster than realtime, with many files in parallel.
+//
+//   mdp_render [--params file] [--jobs N] [--gains] [--out-dir dir] input.wav...
+//
+// For every input it writes <stem>_mix.wav, the mono automix (the sum of the
+// gained channels, from the engine's mixing stage), and with --gains <stem>_gains.wav,
+// one channel per mic holding the automix gain (linear) at blockSize resolution.
+// Both are 32-bit float, sample-aligned with the input: the lookahead latency is
+// trimmed from the front and flushed at the end.
+//
+// Files are streamed in chunks of kChunkFrames; nothing holds a whole file. Each
+// job runs one file on its own engine, single-threaded, so the files rather than
+// the channels are spread across the cores (--jobs, default all of them).
+#include "EnhancedDuganAGC.h"
+#include "RenderSettings.h"
+#include "WavFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr int kChunkFrames = 65536;
+
+    struct Options
+    {
+        RenderSettings settings;
+        std::string outDir;
+        bool writeGains = false;
+        int jobs = 0;
+        std::vector<std::string> inputs;
+    };
+
+    struct Result
+    {
+        bool ok = false;
+        std::string error;
+        double audioSeconds = 0.0;
+        double wallSeconds = 0.0;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    std::string outputPath(const Options& options, const std::string& input, const char* suffix)
+    {
+        namespace fs = std::filesystem;
+        const fs::path in(input);
+        const fs::path dir = options.outDir.empty() ? in.parent_path() : fs::path(options.outDir);
+        return (dir / (in.stem().string() + suffix + ".wav")).string();
+    }
+
+    Result render(const Options& options, const std::string& input)
+    {
+        Result result;
+        const auto started = Clock::now();
+        const RenderSettings& settings = options.settings;
+
+        WavReader reader;
+        if (!reader.open(input))
+        {
+            result.error = reader.getError();
+            return result;
+        }
+
+        const int numChannels = reader.getNumChannels();
+        const int sideChannels = std::min(settings.sidechainChannels, SidechainDetector::kMaxChannels);
+        const int mainChannels = numChannels - sideChannels;
+        if (mainChannels < 1)
+        {
+            result.error = "needs more channels than sidechainChannels";
+            return result;
+        }
+
+        const double sampleRate = reader.getSampleRate();
+        const int blockSize = settings.blockSize;
+
+        EnhancedDuganAGC engine;
+        settings.applyGlobal(engine);
+        engine.setWorkerThreads(0);
+        engine.prepare(sampleRate, blockSize, mainChannels, sideChannels, 1);
+        settings.applyChannels(engine, mainChannels);
+        const int latency = engine.getLatencySamples();
+
+        WavWriter mixWriter, gainWriter;
+        if (!mixWriter.open(outputPath(options, input, "_mix"), 1, sampleRate))
+        {
+            result.error = mixWriter.getError();
+            return result;
+        }
+        if (options.writeGains && !gainWriter.open(outputPath(options, input, "_gains"), mainChannels, sampleRate))
+        {
+            result.error = gainWriter.getError();
+            return result;
+        }
+
+        std::vector<std::vector<float>> audio(static_cast<size_t>(numChannels), std::vector<float>(kChunkFrames));
+        std::vector<std::vector<float>> gains(options.writeGains ? static_cast<size_t>(mainChannels) : 0,
+                                              std::vector<float>(kChunkFrames));
+        std::vector<float> mix(kChunkFrames);
+        std::vector<float*> chunkPointers(static_cast<size_t>(numChannels)), blockPointers(static_cast<size_t>(numChannels));
+        std::vector<const float*> gainPointers(gains.size());
+        for (int ch = 0; ch < numChannels; ++ch)
+            chunkPointers[size_t(ch)] = audio[size_t(ch)].data();
+
+        std::int64_t framesLeft = reader.getNumFrames();
+        int toTrim = latency;
+        int flushLeft = latency;
+        while (framesLeft > 0 || flushLeft > 0)
+        {
+            int n = 0;
+            if (framesLeft > 0)
+            {
+                n = reader.read(chunkPointers.data(), kChunkFrames);
+                if (n == 0)
+                {
+                    result.error = reader.getError();
+                    return result;
+                }
+                framesLeft -= n;
+            }
+            else
+            {
+                // Push the last lookahead's worth of input out of the delay line.
+                n = std::min(flushLeft, kChunkFrames);
+                for (auto& channel : audio)
+                    std::fill(channel.begin(), channel.begin() + n, 0.f);
+                flushLeft -= n;
+            }
+
+            for (int start = 0; start < n; start += blockSize)
+            {
+                const int len = std::min(blockSize, n - start);
+                for (int ch = 0; ch < numChannels; ++ch)
+                    blockPointers[size_t(ch)] = chunkPointers[size_t(ch)] + start;
+
+                float* mixOut = mix.data() + start;
+                engine.processBlock(blockPointers.data(), mainChannels, len,
+                                    sideChannels > 0 ? blockPointers.data() + mainChannels : nullptr, sideChannels, len,
+                                    &mixOut, 1);
+
+                for (size_t ch = 0; ch < gains.size(); ++ch)
+                {
+                    const float g = engine.getChannelAutoGain(static_cast<int>(ch));
+                    std::fill(gains[ch].begin() + start, gains[ch].begin() + start + len, g);
+                }
+            }
+
+            const int skip = std::min(toTrim, n);
+            toTrim -= skip;
+            const float* mixOut = mix.data() + skip;
+            bool written = mixWriter.write(&mixOut, n - skip);
+            if (written && options.writeGains)
+            {
+                for (size_t ch = 0; ch < gains.size(); ++ch)
+                    gainPointers[ch] = gains[ch].data() + skip;
+                written = gainWriter.write(gainPointers.data(), n - skip);
+            }
+            if (!written)
+            {
+                result.error = mixWriter.getError().empty() ? gainWriter.getError() : mixWriter.getError();
+                return result;
+            }
+        }
+
+        if (!mixWriter.close() || (options.writeGains && !gainWriter.close()))
+        {
+            result.error = mixWriter.getError().empty() ? gainWriter.getError() : mixWriter.getError();
+            return result;
+        }
+
+        result.ok = true;
+        result.audioSeconds = static_cast<double>(reader.getNumFrames()) / sampleRate;
+        result.wallSeconds = std::chrono::duration<double>(Clock::now() - started).count();
+        return result;
+    }
+
+    int usage()
+    {
+        std::fprintf(stderr, "usage: mdp_render [--params file] [--jobs N] [--gains] [--out-dir dir] input.wav...\n");
+        return 2;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--params" && hasValue)
+        {
+            std::string error;
+            if (!options.settings.load(argv[++i], error))
+            {
+                std::fprintf(stderr, "mdp_render: %s\n", error.c_str());
+                return 2;
+            }
+        }
+        else if (arg == "--jobs" && hasValue)      options.jobs = std::atoi(argv[++i]);
+        else if (arg == "--out-dir" && hasValue)   options.outDir = argv[++i];
+        else if (arg == "--gains")                 options.writeGains = true;
+        else if (arg.rfind("--", 0) == 0)          return usage();
+        else                                       options.inputs.push_back(arg);
+    }
+    if (options.inputs.empty())
+        return usage();
+
+    if (!options.outDir.empty())
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(options.outDir, ec);
+    }
+
+    const int numFiles = static_cast<int>(options.inputs.size());
+    int jobs = options.jobs > 0 ? options.jobs : static_cast<int>(std::thread::hardware_concurrency());
+    jobs = std::clamp(jobs, 1, numFiles);
+
+    std::atomic<int> nextFile { 0 };
+    std::atomic<int> failures { 0 };
+    std::mutex printLock;
+    double totalAudioSeconds = 0.0;
+    const auto started = Clock::now();
+
+    auto worker = [&]
+    {
+        for (int index = nextFile++; index < numFiles; index = nextFile++)
+        {
+            const std::string& input = options.inputs[size_t(index)];
+            const Result result = render(options, input);
+
+            std::lock_guard<std::mutex> lock(printLock);
+            if (result.ok)
+            {
+                totalAudioSeconds += result.audioSeconds;
+                std::printf("%s: %.1f s of audio in %.2f s (%.1fx realtime)\n", input.c_str(),
+                            result.audioSeconds, result.wallSeconds, result.audioSeconds / std::max(result.wallSeconds, 1e-9));
+            }
+            else
+            {
+                ++failures;
+                std::fprintf(stderr, "%s: %s\n", input.c_str(), result.error.c_str());
+            }
+            std::fflush(stdout);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < jobs; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+
+    const double wallSeconds = std::chrono::duration<double>(Clock::now() - started).count();
+    std::printf("%d file(s), %d job(s): %.1f s of audio in %.2f s (%.1fx realtime)\n",
+                numFiles - failures.load(), jobs, totalAudioSeconds, wallSeconds,
+                totalAudioSeconds / std::max(wallSeconds, 1e-9));
+    return failures.load() == 0 ? 0 : 1;
+}